@@ -0,0 +1,510 @@
+#include "archive.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common.hpp"
+
+namespace {
+
+constexpr char kMagic[8] = { 'S', 'S', 'A', 'R', 'C', 'H', '\0', '\0' };
+constexpr uint32_t kVersion = 5;       // 2 adds checkpoints, 3 widens the IFF mask, 4 adds terrain,
+                                       // 5 adds platform and has_closing
+constexpr size_t kHeaderBytes = 16;   // magic, version, padding
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+size_t pad8(size_t n) { return (n + 7) & ~size_t(7); }
+
+// Byte size of a group's columns; every column starts 8-byte aligned
+size_t groupBytes(size_t rows, size_t fields, size_t bytes) {
+    return fields * rows * sizeof(double) + pad8(rows * sizeof(uint32_t)) + bytes * pad8(rows);
+}
+
+// Same columns minus the id, which is the row number
+size_t checkpointBytes(size_t tracks, size_t fields, size_t bytes) {
+    return fields * tracks * sizeof(double) + bytes * pad8(tracks);
+}
+
+template <class T>
+void put(std::ofstream& out, const T& v) {
+    out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+void putPadded(std::ofstream& out, const void* p, size_t bytes) {
+    static const char zeros[8] = {};
+    out.write(static_cast<const char*>(p), static_cast<std::streamsize>(bytes));
+    out.write(zeros, static_cast<std::streamsize>(pad8(bytes) - bytes));
+}
+
+// Bounds-checked reader over the mapped footer
+struct Cursor {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    template <class T>
+    T get() {
+        if (static_cast<size_t>(end - p) < sizeof(T)) throw std::runtime_error("Corrupt archive footer");
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return v;
+    }
+    std::string str(size_t n) {
+        if (static_cast<size_t>(end - p) < n) throw std::runtime_error("Corrupt archive footer");
+        std::string s(reinterpret_cast<const char*>(p), n);
+        p += n;
+        return s;
+    }
+};
+
+} // namespace
+
+// -------------------- ArchiveWriter --------------------
+ArchiveWriter::ArchiveWriter(const std::string& path, size_t groupRows, double partitionS,
+                             double checkpointS)
+    : out_(path, std::ios::binary | std::ios::trunc),
+      groupRows_(std::max<size_t>(1, groupRows)), partitionS_(partitionS),
+      checkpointS_(checkpointS), nextCheckpoint_(kInf) {
+    if (!out_) throw std::runtime_error("Failed to create archive: " + path);
+    out_.write(kMagic, sizeof(kMagic));
+    put(out_, kVersion);
+    put(out_, uint32_t(0));
+}
+
+void ArchiveWriter::add(const Update& u) {
+    if (finished_) throw std::runtime_error("Archive already finished");
+    if (u.t < lastT_) throw std::runtime_error("Archive input out of time order at t=" + std::to_string(u.t));
+    lastT_ = u.t;
+
+    if (checkpointS_ > 0.0) {
+        const double boundary = std::floor(u.t / checkpointS_) * checkpointS_;
+        if (rows_ > 0 && u.t >= nextCheckpoint_) checkpoint(boundary);
+        if (rows_ == 0 || u.t >= nextCheckpoint_) nextCheckpoint_ = boundary + checkpointS_;
+    }
+
+    const int64_t part = partitionS_ > 0.0 ? static_cast<int64_t>(std::floor(u.t / partitionS_)) : 0;
+    if (!id_.empty() && (part != partition_ || id_.size() >= groupRows_)) flush();
+    partition_ = part;
+
+    auto [it, fresh] = index_.try_emplace(u.c.id, static_cast<uint32_t>(ids_.size()));
+    if (fresh) {
+        ids_.push_back(u.c.id);
+        class_.push_back(Platform::Unclassified);
+    }
+
+    const Contact& c = u.c;
+    Platform& cls = class_[it->second];
+    if (c.platform != Platform::Unclassified) cls = c.platform;
+    if (checkpointS_ > 0.0) {
+        if (fresh) {
+            latest_.push_back(u);
+        } else {
+            Update& l = latest_[it->second];   // id unchanged
+            l.t = u.t;
+            l.c.iff = c.iff;
+            l.c.range_km = c.range_km;
+            l.c.closing_mps = c.closing_mps;
+            l.c.altitude_m = c.altitude_m;
+            l.c.rcs_m2 = c.rcs_m2;
+            l.c.has_pos = c.has_pos;
+            l.c.east_km = c.east_km;
+            l.c.north_km = c.north_km;
+            l.c.terrain_m = c.terrain_m;
+            l.c.has_closing = c.has_closing;
+        }
+        latest_[it->second].c.platform = cls;
+    }
+    num_[size_t(ArchiveField::Time)].push_back(u.t);
+    num_[size_t(ArchiveField::Range)].push_back(c.range_km);
+    num_[size_t(ArchiveField::Closing)].push_back(c.closing_mps);
+    num_[size_t(ArchiveField::Altitude)].push_back(c.altitude_m);
+    num_[size_t(ArchiveField::Rcs)].push_back(c.rcs_m2);
+    num_[size_t(ArchiveField::East)].push_back(c.east_km);
+    num_[size_t(ArchiveField::North)].push_back(c.north_km);
+    num_[size_t(ArchiveField::Terrain)].push_back(c.terrain_m);
+    id_.push_back(it->second);
+    iff_.push_back(static_cast<uint8_t>(c.iff));
+    hasPos_.push_back(c.has_pos ? 1 : 0);
+    platform_.push_back(static_cast<uint8_t>(cls));
+    hasClosing_.push_back(c.has_closing ? 1 : 0);
+    ++rows_;
+}
+
+void ArchiveWriter::flush() {
+    const size_t n = id_.size();
+    if (n == 0) return;
+
+    RowGroup g;
+    g.offset = static_cast<uint64_t>(out_.tellp());
+    g.rows = static_cast<uint32_t>(n);
+    for (size_t f = 0; f < kArchiveFields; ++f) {
+        g.zone.lo[f] = kInf;
+        g.zone.hi[f] = -kInf;
+        const bool posOnly = f == size_t(ArchiveField::East) || f == size_t(ArchiveField::North);
+        for (size_t i = 0; i < n; ++i) {
+            if (posOnly && !hasPos_[i]) continue;
+            g.zone.lo[f] = std::min(g.zone.lo[f], num_[f][i]);
+            g.zone.hi[f] = std::max(g.zone.hi[f], num_[f][i]);
+        }
+    }
+    for (uint8_t v : iff_) g.zone.iffMask |= static_cast<uint16_t>(1u << v);
+
+    for (size_t f = 0; f < kArchiveFields; ++f) putPadded(out_, num_[f].data(), n * sizeof(double));
+    putPadded(out_, id_.data(), n * sizeof(uint32_t));
+    putPadded(out_, iff_.data(), n);
+    putPadded(out_, hasPos_.data(), n);
+    putPadded(out_, platform_.data(), n);
+    putPadded(out_, hasClosing_.data(), n);
+    groups_.push_back(g);
+
+    for (auto& col : num_) col.clear();
+    id_.clear();
+    iff_.clear();
+    hasPos_.clear();
+    platform_.clear();
+    hasClosing_.clear();
+}
+
+void ArchiveWriter::checkpoint(double time) {
+    Checkpoint cp;
+    cp.time = time;
+    cp.rowsBefore = rows_;
+    cp.offset = static_cast<uint64_t>(out_.tellp());
+    cp.tracks = static_cast<uint32_t>(latest_.size());
+
+    const size_t n = latest_.size();
+    std::vector<double> col(n);
+    std::vector<uint8_t> bytes(n);
+    auto numeric = [&](auto field) {
+        for (size_t i = 0; i < n; ++i) col[i] = field(latest_[i]);
+        putPadded(out_, col.data(), n * sizeof(double));
+    };
+    // ArchiveField order
+    numeric([](const Update& u) { return u.t; });
+    numeric([](const Update& u) { return u.c.range_km; });
+    numeric([](const Update& u) { return u.c.closing_mps; });
+    numeric([](const Update& u) { return u.c.altitude_m; });
+    numeric([](const Update& u) { return u.c.rcs_m2; });
+    numeric([](const Update& u) { return u.c.east_km; });
+    numeric([](const Update& u) { return u.c.north_km; });
+    numeric([](const Update& u) { return u.c.terrain_m; });
+    for (size_t i = 0; i < n; ++i) bytes[i] = static_cast<uint8_t>(latest_[i].c.iff);
+    putPadded(out_, bytes.data(), n);
+    for (size_t i = 0; i < n; ++i) bytes[i] = latest_[i].c.has_pos ? 1 : 0;
+    putPadded(out_, bytes.data(), n);
+    for (size_t i = 0; i < n; ++i) bytes[i] = static_cast<uint8_t>(latest_[i].c.platform);
+    putPadded(out_, bytes.data(), n);
+    for (size_t i = 0; i < n; ++i) bytes[i] = latest_[i].c.has_closing ? 1 : 0;
+    putPadded(out_, bytes.data(), n);
+    checkpoints_.push_back(cp);
+}
+
+void ArchiveWriter::finish() {
+    if (finished_) return;
+    flush();
+    finished_ = true;
+
+    const uint64_t footer = static_cast<uint64_t>(out_.tellp());
+    put(out_, static_cast<uint32_t>(ids_.size()));
+    for (const auto& id : ids_) {
+        put(out_, static_cast<uint32_t>(id.size()));
+        out_.write(id.data(), static_cast<std::streamsize>(id.size()));
+    }
+    put(out_, static_cast<uint32_t>(groups_.size()));
+    for (const auto& g : groups_) {
+        put(out_, g.offset);
+        put(out_, g.rows);
+        put(out_, g.zone.iffMask);
+        for (double v : g.zone.lo) put(out_, v);
+        for (double v : g.zone.hi) put(out_, v);
+    }
+    put(out_, static_cast<uint32_t>(checkpoints_.size()));
+    for (const auto& cp : checkpoints_) {
+        put(out_, cp.time);
+        put(out_, cp.rowsBefore);
+        put(out_, cp.offset);
+        put(out_, cp.tracks);
+    }
+    put(out_, footer);
+    out_.write(kMagic, sizeof(kMagic));
+    out_.flush();
+    if (!out_) throw std::runtime_error("Failed writing archive");
+}
+
+// -------------------- ArchiveQuery --------------------
+ArchiveQuery::ArchiveQuery() {
+    std::fill(std::begin(lo), std::end(lo), -kInf);
+    std::fill(std::begin(hi), std::end(hi), kInf);
+}
+
+void ArchiveQuery::bound(ArchiveField f, double l, double h) {
+    lo[size_t(f)] = std::max(lo[size_t(f)], l);
+    hi[size_t(f)] = std::min(hi[size_t(f)], h);
+}
+
+bool ArchiveQuery::bounded(ArchiveField f) const {
+    return lo[size_t(f)] != -kInf || hi[size_t(f)] != kInf;
+}
+
+bool ArchiveQuery::mayMatch(const ZoneMap& z) const {
+    if ((z.iffMask & iffMask) == 0) return false;
+    for (size_t f = 0; f < kArchiveFields; ++f) {
+        if (!bounded(ArchiveField(f))) continue;
+        if (z.hi[f] < lo[f] || z.lo[f] > hi[f]) return false;   // also rejects empty East/North
+    }
+    return true;
+}
+
+// -------------------- Archive --------------------
+Archive::Archive(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Failed to open archive: " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(kHeaderBytes + 16)) {
+        ::close(fd);
+        throw std::runtime_error("Not an archive: " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) throw std::runtime_error("Failed to map archive: " + path);
+    data_ = static_cast<const uint8_t*>(p);
+
+    try {
+        uint32_t version;
+        std::memcpy(&version, data_ + sizeof(kMagic), sizeof(version));
+        if (std::memcmp(data_, kMagic, sizeof(kMagic)) != 0 ||
+            std::memcmp(data_ + size_ - sizeof(kMagic), kMagic, sizeof(kMagic)) != 0) {
+            throw std::runtime_error("Not an archive (or unfinished): " + path);
+        }
+        if (version < 1 || version > kVersion) throw std::runtime_error("Unsupported archive version in " + path);
+        // Terrain (the last field) arrived in version 4
+        fields_ = version >= 4 ? kArchiveFields : kArchiveFields - 1;
+        // Platform and has_closing arrived in version 5
+        bytes_ = version >= 5 ? 4 : 2;
+
+        uint64_t footer;
+        std::memcpy(&footer, data_ + size_ - sizeof(kMagic) - sizeof(footer), sizeof(footer));
+        if (footer < kHeaderBytes || footer > size_) throw std::runtime_error("Corrupt archive footer");
+        Cursor cur { data_ + footer, data_ + size_ - sizeof(kMagic) - sizeof(footer) };
+
+        ids_.resize(cur.get<uint32_t>());
+        for (auto& id : ids_) id = cur.str(cur.get<uint32_t>());
+
+        groups_.resize(cur.get<uint32_t>());
+        for (auto& g : groups_) {
+            g.offset = cur.get<uint64_t>();
+            g.rows = cur.get<uint32_t>();
+            // Before version 3 only Friend, Foe and Unknown existed
+            g.zone.iffMask = version >= 3 ? cur.get<uint16_t>() : cur.get<uint8_t>();
+            for (size_t f = 0; f < kArchiveFields; ++f) g.zone.lo[f] = f < fields_ ? cur.get<double>() : 0.0;
+            for (size_t f = 0; f < kArchiveFields; ++f) g.zone.hi[f] = f < fields_ ? cur.get<double>() : 0.0;
+            if (g.offset + groupBytes(g.rows, fields_, bytes_) > footer) throw std::runtime_error("Corrupt archive footer");
+            firstRow_.push_back(rows_);
+            rows_ += g.rows;
+        }
+
+        if (version >= 2) {
+            checkpoints_.resize(cur.get<uint32_t>());
+            for (auto& cp : checkpoints_) {
+                cp.time = cur.get<double>();
+                cp.rowsBefore = cur.get<uint64_t>();
+                cp.offset = cur.get<uint64_t>();
+                cp.tracks = cur.get<uint32_t>();
+                if (cp.offset + checkpointBytes(cp.tracks, fields_, bytes_) > footer || cp.tracks > ids_.size() ||
+                    cp.rowsBefore > rows_) {
+                    throw std::runtime_error("Corrupt archive footer");
+                }
+            }
+        }
+        if (fields_ < kArchiveFields || bytes_ < 4) {
+            size_t longest = 0;
+            for (const auto& g : groups_) longest = std::max<size_t>(longest, g.rows);
+            for (const auto& cp : checkpoints_) longest = std::max<size_t>(longest, cp.tracks);
+            if (fields_ < kArchiveFields) zeros_.assign(longest, 0.0);
+            if (bytes_ < 4) {
+                unclassified_.assign(longest, static_cast<uint8_t>(Platform::Unclassified));
+                ones_.assign(longest, 1);
+            }
+        }
+    } catch (...) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+        throw;
+    }
+}
+
+Archive::~Archive() {
+    munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+Archive::Group Archive::group(size_t g) const {
+    const RowGroup& rg = groups_[g];
+    const size_t n = rg.rows;
+    const uint8_t* p = data_ + rg.offset;
+    Group grp;
+    grp.rows = n;
+    for (size_t f = 0; f < fields_; ++f) {
+        grp.num[f] = reinterpret_cast<const double*>(p);
+        p += n * sizeof(double);
+    }
+    for (size_t f = fields_; f < kArchiveFields; ++f) grp.num[f] = zeros_.data();
+    grp.id = reinterpret_cast<const uint32_t*>(p);
+    p += pad8(n * sizeof(uint32_t));
+    grp.iff = p;
+    p += pad8(n);
+    grp.hasPos = p;
+    p += pad8(n);
+    grp.platform = bytes_ >= 4 ? p : unclassified_.data();
+    p += pad8(n);
+    grp.hasClosing = bytes_ >= 4 ? p : ones_.data();
+
+    // The footer only bounds the group's extent. Its id, IFF and platform
+    // columns index ids_ and the per-class tables, so a corrupt file must
+    // not reach those lookups.
+    uint32_t maxId = 0;
+    uint8_t maxIff = 0, maxPlatform = 0;
+    for (size_t i = 0; i < n; ++i) maxId = std::max(maxId, grp.id[i]);
+    for (size_t i = 0; i < n; ++i) maxIff = std::max(maxIff, grp.iff[i]);
+    for (size_t i = 0; i < n; ++i) maxPlatform = std::max(maxPlatform, grp.platform[i]);
+    if (n > 0 && maxId >= ids_.size()) throw std::runtime_error("Corrupt archive: track id out of range");
+    if (maxIff >= kIffs) throw std::runtime_error("Corrupt archive: IFF value out of range");
+    if (maxPlatform >= kPlatforms) throw std::runtime_error("Corrupt archive: platform value out of range");
+    return grp;
+}
+
+Update Archive::row(const Group& grp, size_t i) const {
+    Update u;
+    u.t = grp.num[size_t(ArchiveField::Time)][i];
+    Contact& c = u.c;
+    c.id          = ids_[grp.id[i]];
+    c.iff         = static_cast<IFF>(grp.iff[i]);
+    c.range_km    = grp.num[size_t(ArchiveField::Range)][i];
+    c.closing_mps = grp.num[size_t(ArchiveField::Closing)][i];
+    c.altitude_m  = grp.num[size_t(ArchiveField::Altitude)][i];
+    c.rcs_m2      = grp.num[size_t(ArchiveField::Rcs)][i];
+    c.has_pos     = grp.hasPos[i] != 0;
+    c.east_km     = grp.num[size_t(ArchiveField::East)][i];
+    c.north_km    = grp.num[size_t(ArchiveField::North)][i];
+    c.terrain_m   = grp.num[size_t(ArchiveField::Terrain)][i];
+    c.has_closing = grp.hasClosing[i] != 0;
+    c.platform    = static_cast<Platform>(grp.platform[i]);
+    return u;
+}
+
+std::vector<Update> Archive::scan(const ArchiveQuery& q, size_t threads,
+                                  ArchiveScanStats* stats) const {
+    std::vector<size_t> todo;
+    for (size_t g = 0; g < groups_.size(); ++g) {
+        if (q.mayMatch(groups_[g].zone)) todo.push_back(g);
+    }
+
+    std::vector<std::vector<Update>> found(todo.size());
+    std::atomic<size_t> next{0}, scanned{0};
+    auto worker = [&](size_t) {
+        std::vector<uint8_t> sel;
+        for (size_t k; (k = next.fetch_add(1)) < todo.size();) {
+            const Group grp = group(todo[k]);
+            const size_t n = grp.rows;
+
+            // Column at a time: each bounded field narrows the selection
+            sel.assign(n, 1);
+            for (size_t i = 0; i < n; ++i) sel[i] &= (q.iffMask >> grp.iff[i]) & 1;
+            for (size_t f = 0; f < kArchiveFields; ++f) {
+                if (!q.bounded(ArchiveField(f))) continue;
+                const double* col = grp.num[f];
+                const double lo = q.lo[f], hi = q.hi[f];
+                for (size_t i = 0; i < n; ++i) sel[i] &= (col[i] >= lo) & (col[i] <= hi);
+                if (f == size_t(ArchiveField::East) || f == size_t(ArchiveField::North)) {
+                    for (size_t i = 0; i < n; ++i) sel[i] &= grp.hasPos[i];
+                }
+            }
+            for (size_t i = 0; i < n; ++i) {
+                if (sel[i]) found[k].push_back(row(grp, i));
+            }
+            scanned.fetch_add(n, std::memory_order_relaxed);
+        }
+    };
+
+    parallel(std::max<size_t>(1, std::min(threads, todo.size())), worker);
+
+    std::vector<Update> out;
+    for (auto& f : found) out.insert(out.end(), std::make_move_iterator(f.begin()),
+                                     std::make_move_iterator(f.end()));
+    if (stats) {
+        stats->groups = groups_.size();
+        stats->skipped = groups_.size() - todo.size();
+        stats->rowsScanned = scanned.load();
+        stats->matched = out.size();
+    }
+    return out;
+}
+
+void Archive::restoreAt(double t, TrackStore& store, AsOfStats* stats) const {
+    AsOfStats st;
+
+    // Last checkpoint whose picture lies entirely at or before t
+    auto cp = std::upper_bound(checkpoints_.begin(), checkpoints_.end(), t,
+                               [](double v, const Checkpoint& c) { return v < c.time; });
+    uint64_t from = 0;
+    if (cp != checkpoints_.begin()) {
+        --cp;
+        const size_t n = cp->tracks;
+        const double* num[kArchiveFields];
+        const uint8_t* p = data_ + cp->offset;
+        for (size_t f = 0; f < fields_; ++f) {
+            num[f] = reinterpret_cast<const double*>(p);
+            p += n * sizeof(double);
+        }
+        for (size_t f = fields_; f < kArchiveFields; ++f) num[f] = zeros_.data();
+        const uint8_t* iff = p;
+        const uint8_t* hasPos = p + pad8(n);
+        const uint8_t* platform = bytes_ >= 4 ? p + 2 * pad8(n) : unclassified_.data();
+        const uint8_t* hasClosing = bytes_ >= 4 ? p + 3 * pad8(n) : ones_.data();
+        if (n > 0 && *std::max_element(iff, iff + n) >= kIffs) {
+            throw std::runtime_error("Corrupt archive: IFF value out of range");
+        }
+        if (n > 0 && *std::max_element(platform, platform + n) >= kPlatforms) {
+            throw std::runtime_error("Corrupt archive: platform value out of range");
+        }
+        for (size_t i = 0; i < n; ++i) {
+            Contact c { ids_[i], static_cast<IFF>(iff[i]), num[size_t(ArchiveField::Range)][i],
+                        num[size_t(ArchiveField::Closing)][i], num[size_t(ArchiveField::Altitude)][i],
+                        num[size_t(ArchiveField::Rcs)][i] };
+            c.has_pos  = hasPos[i] != 0;
+            c.east_km  = num[size_t(ArchiveField::East)][i];
+            c.north_km = num[size_t(ArchiveField::North)][i];
+            c.terrain_m = num[size_t(ArchiveField::Terrain)][i];
+            c.has_closing = hasClosing[i] != 0;
+            c.platform = static_cast<Platform>(platform[i]);
+            store.upsert(c, num[size_t(ArchiveField::Time)][i]);
+        }
+        st.checkpoint = cp->time;
+        st.restored = n;
+        from = cp->rowsBefore;
+    }
+
+    // Replay forward from the checkpoint's row until past t
+    size_t g = static_cast<size_t>(std::upper_bound(firstRow_.begin(), firstRow_.end(), from) -
+                                   firstRow_.begin());
+    g = g > 0 ? g - 1 : 0;
+    size_t i = from - (g < firstRow_.size() ? firstRow_[g] : 0);
+    for (; g < groups_.size() && groups_[g].zone.lo[size_t(ArchiveField::Time)] <= t; ++g, i = 0) {
+        const Group grp = group(g);
+        const double* time = grp.num[size_t(ArchiveField::Time)];
+        for (; i < grp.rows && time[i] <= t; ++i) {
+            Update u = row(grp, i);
+            store.upsert(u.c, u.t);
+            ++st.replayed;
+        }
+        if (i < grp.rows) break;
+    }
+    if (stats) *stats = st;
+}
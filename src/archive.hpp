@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "stream.hpp"
+#include "track_store.hpp"
+
+// -------------------- Columnar Archive --------------------
+// Update history on disk, for historical queries without re-parsing CSV.
+// Updates are appended in time order and cut into row groups: a group
+// closes at groupRows rows or when the time crosses a partition boundary
+// (partitionS seconds), so no group spans two partitions. Each group stores
+// one column per field plus a zone map (min/max of every numeric field and
+// the set of IFF values present); queries skip groups whose zone map cannot
+// match and only scan the rest. Track ids are dictionary-encoded for the
+// whole archive. Native (little-endian) byte order.
+//
+// Every checkpointS seconds the writer also stores a checkpoint: the latest
+// update of every track seen so far. Reconstructing the picture at time T
+// loads the last checkpoint at or before T and replays only the updates
+// after it, so the cost is bounded by the checkpoint interval rather than
+// by the length of the archive.
+//
+// Terrain is the ground elevation under the contact, so history is scored on
+// height above ground like the live picture. It is 0 without a DEM, and for
+// archives older than version 4, which have no such column.
+//
+// Each row also stores the track's platform class as of that update (a
+// class reported earlier is kept, as TrackStore does) and whether closing
+// speed was reported. Archives older than version 5 read as unclassified
+// with closing reported.
+enum class ArchiveField : uint8_t { Time, Range, Closing, Altitude, Rcs, East, North, Terrain };
+constexpr size_t kArchiveFields = 8;
+
+// East/North bounds cover rows with a position only; +inf/-inf if none.
+static_assert(kIffs <= 16, "IFF masks are 16 bits");
+
+struct ZoneMap {
+    double lo[kArchiveFields];
+    double hi[kArchiveFields];
+    uint16_t iffMask = 0;       // bit per IFF value
+};
+
+struct RowGroup {
+    uint64_t offset = 0;        // byte offset of the group's columns
+    uint32_t rows = 0;
+    ZoneMap zone;
+};
+
+// Picture made of every update with t < time: rows [0, rowsBefore).
+struct Checkpoint {
+    double time = 0.0;
+    uint64_t rowsBefore = 0;
+    uint64_t offset = 0;        // byte offset of the per-track columns
+    uint32_t tracks = 0;        // dictionary ids [0, tracks)
+};
+
+class ArchiveWriter {
+public:
+    // checkpointS <= 0 disables checkpoints.
+    ArchiveWriter(const std::string& path, size_t groupRows = 65536, double partitionS = 3600.0,
+                  double checkpointS = 3600.0);
+
+    // t must not go backwards.
+    void add(const Update& u);
+
+    // Flush the last group and write the footer. Until then the file has
+    // no directory and cannot be opened.
+    void finish();
+
+    size_t rows() const { return rows_; }
+    size_t groups() const { return groups_.size(); }
+    size_t checkpoints() const { return checkpoints_.size(); }
+
+private:
+    void flush();
+    void checkpoint(double time);
+
+    std::ofstream out_;
+    size_t groupRows_;
+    double partitionS_;
+    double checkpointS_;
+    double nextCheckpoint_;
+    size_t rows_ = 0;
+    double lastT_ = -std::numeric_limits<double>::infinity();
+    int64_t partition_ = 0;
+    bool finished_ = false;
+
+    std::unordered_map<std::string, uint32_t> index_;
+    std::vector<std::string> ids_;
+    std::vector<RowGroup> groups_;
+    std::vector<Checkpoint> checkpoints_;
+    std::vector<Update> latest_;   // per dictionary id, for checkpoints
+    std::vector<Platform> class_;  // per dictionary id, last class reported
+
+    // Current group, column-wise
+    std::vector<double> num_[kArchiveFields];
+    std::vector<uint32_t> id_;
+    std::vector<uint8_t> iff_, hasPos_, platform_, hasClosing_;
+};
+
+// Conjunctive predicate: each field within [lo, hi] and IFF in iffMask.
+// A bound on East/North only matches rows that carry a position.
+struct ArchiveQuery {
+    double lo[kArchiveFields];
+    double hi[kArchiveFields];
+    uint16_t iffMask = 0xffff;
+
+    ArchiveQuery();
+
+    void bound(ArchiveField f, double lo, double hi);
+    bool bounded(ArchiveField f) const;
+
+    // False if no row of a group with this zone map can match
+    bool mayMatch(const ZoneMap& z) const;
+};
+
+struct AsOfStats {
+    double checkpoint = 0.0;     // time of the checkpoint used (0 if none)
+    size_t restored = 0;         // tracks loaded from it
+    size_t replayed = 0;         // updates applied after it
+};
+
+struct ArchiveScanStats {
+    size_t groups = 0;
+    size_t skipped = 0;          // by zone map
+    size_t rowsScanned = 0;
+    size_t matched = 0;
+};
+
+// Read-only view of an archive file (memory-mapped, so groups that are
+// skipped are never read from disk).
+class Archive {
+public:
+    explicit Archive(const std::string& path);
+    ~Archive();
+
+    Archive(const Archive&) = delete;
+    Archive& operator=(const Archive&) = delete;
+
+    // Columns of one row group
+    struct Group {
+        size_t rows;
+        const double* num[kArchiveFields];
+        const uint32_t* id;
+        const uint8_t* iff;
+        const uint8_t* hasPos;
+        const uint8_t* platform;
+        const uint8_t* hasClosing;
+    };
+
+    size_t groups() const { return groups_.size(); }
+    size_t rows() const { return rows_; }
+    const RowGroup& rowGroup(size_t g) const { return groups_[g]; }
+    const std::vector<Checkpoint>& checkpoints() const { return checkpoints_; }
+    // Throws std::runtime_error if the group's columns are corrupt
+    Group group(size_t g) const;
+    const std::vector<std::string>& ids() const { return ids_; }
+
+    Update row(const Group& grp, size_t i) const;
+
+    // Matching rows in archive (time) order, scanning the groups that pass
+    // the zone maps on up to `threads` threads.
+    std::vector<Update> scan(const ArchiveQuery& q, size_t threads,
+                             ArchiveScanStats* stats = nullptr) const;
+
+    // Load into an empty store the picture as of time t: every track's
+    // latest update with update time <= t. Scores are left for the caller.
+    void restoreAt(double t, TrackStore& store, AsOfStats* stats = nullptr) const;
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t rows_ = 0;
+    std::vector<std::string> ids_;
+    std::vector<RowGroup> groups_;
+    std::vector<uint64_t> firstRow_;   // per group
+    std::vector<Checkpoint> checkpoints_;
+    size_t fields_ = kArchiveFields;   // numeric columns stored (older versions have fewer)
+    size_t bytes_ = 4;                 // byte columns stored (iff, hasPos[, platform, hasClosing])
+    std::vector<double> zeros_;        // stands in for the columns they lack
+    std::vector<uint8_t> unclassified_, ones_;
+};
@@ -0,0 +1,298 @@
+#include "archive_tool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "archive.hpp"
+#include "calibration.hpp"
+#include "geodesy.hpp"
+#include "profile.hpp"
+#include "report.hpp"
+#include "stream.hpp"
+#include "terrain.hpp"
+#include "track_store.hpp"
+#include "track_summary.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void usage() {
+    std::cerr << "usage: sentinelscore archive build OUT.ssa updates.csv... [--group-rows N]"
+                 " [--partition-s S] [--checkpoint-s S]\n"
+                 "                 [--origin LAT,LON[,ALT_M] [--dem DIR]] [--calibration FILE]\n"
+                 "       sentinelscore archive query FILE.ssa [--from T] [--to T] [--iff FOE,UNKNOWN]\n"
+                 "                 [--range LO:HI] [--closing LO:HI] [--alt LO:HI] [--rcs LO:HI]\n"
+                 "                 [--east LO:HI] [--north LO:HI] [--threads N] [--count]\n"
+                 "       sentinelscore archive asof FILE.ssa T [--profile FILE] [--top K]\n"
+                 "       sentinelscore archive report FILE.ssa [--profile FILE] [--from T] [--to T]\n"
+                 "                 [--threads N] [--top K]\n";
+}
+
+// "LO:HI", either side may be empty
+void parseBound(const std::string& s, ArchiveQuery& q, ArchiveField f) {
+    auto colon = s.find(':');
+    if (colon == std::string::npos) throw std::runtime_error("Expected LO:HI, got " + s);
+    const double inf = std::numeric_limits<double>::infinity();
+    std::string lo = trim(s.substr(0, colon)), hi = trim(s.substr(colon + 1));
+    q.bound(f, lo.empty() ? -inf : std::stod(lo), hi.empty() ? inf : std::stod(hi));
+}
+
+int build(int argc, char** argv) {
+    std::string out;
+    std::vector<std::string> inputs;
+    size_t groupRows = 65536;
+    double partitionS = 3600.0;
+    double checkpointS = 3600.0;
+    std::unique_ptr<LocalFrame> frame;   // feeds report latitude/longitude
+    std::string demDir;                  // terrain for the altitude term; needs an origin
+    std::string calibrationPath;         // per-feed bias corrections, as in serve
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--group-rows" && i + 1 < argc) {
+            groupRows = static_cast<size_t>(std::stoull(argv[++i]));
+        } else if (arg == "--partition-s" && i + 1 < argc) {
+            partitionS = std::stod(argv[++i]);
+        } else if (arg == "--checkpoint-s" && i + 1 < argc) {
+            checkpointS = std::stod(argv[++i]);
+        } else if (arg == "--origin" && i + 1 < argc) {
+            frame = std::make_unique<LocalFrame>(LocalFrame::parse(argv[++i]));
+        } else if (arg == "--dem" && i + 1 < argc) {
+            demDir = argv[++i];
+        } else if (arg == "--calibration" && i + 1 < argc) {
+            calibrationPath = argv[++i];
+        } else if (arg == "-" || (!arg.empty() && arg[0] != '-')) {
+            if (out.empty()) out = arg;
+            else inputs.push_back(arg);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (out.empty() || inputs.empty() || (!demDir.empty() && !frame)) {
+        usage();
+        return 2;
+    }
+    std::unique_ptr<ElevationModel> dem;
+    if (!demDir.empty()) dem = std::make_unique<ElevationModel>(demDir);
+
+    std::unique_ptr<CalibrationTable> calibration;
+    if (!calibrationPath.empty()) {
+        calibration = std::make_unique<CalibrationTable>(CalibrationTable::load(calibrationPath));
+        for (const auto& feed : calibration->unmatched(inputs)) {
+            std::cerr << "calibration: no feed named " << feed << "\n";
+        }
+        if (frame && calibration->correctsRange()) {
+            std::cerr << "calibration: range corrections are lost with --origin for updates with a "
+                         "position (their range is recomputed from it); RCS corrections still apply\n";
+        }
+    }
+
+    auto t0 = Clock::now();
+    ArchiveWriter w(out, groupRows, partitionS, checkpointS);
+    MergedUpdateReader feeds(inputs, 1024, calibration.get(), frame != nullptr);
+    Update u;
+    if (!frame) {
+        while (feeds.next(u)) w.add(u);
+    } else {
+        // The archive stores local positions and the terrain under them,
+        // a batch at a time as in serve
+        std::vector<Update> batch;
+        auto flush = [&]() {
+            if (dem) dem->annotate(batch);
+            frame->convert(batch);
+            for (const Update& b : batch) w.add(b);
+            batch.clear();
+        };
+        while (feeds.next(u)) {
+            batch.push_back(std::move(u));
+            if (batch.size() == 4096) flush();
+        }
+        flush();
+    }
+    w.finish();
+    std::cerr << "archived " << w.rows() << " updates in " << w.groups() << " row groups, "
+              << w.checkpoints() << " checkpoints ("
+              << std::fixed << std::setprecision(1)
+              << std::chrono::duration<double, std::milli>(Clock::now() - t0).count() << " ms)\n";
+    return 0;
+}
+
+int query(int argc, char** argv) {
+    std::string path;
+    ArchiveQuery q;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    bool countOnly = false;
+    const double inf = std::numeric_limits<double>::infinity();
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--from" && i + 1 < argc) {
+            q.bound(ArchiveField::Time, std::stod(argv[++i]), inf);
+        } else if (arg == "--to" && i + 1 < argc) {
+            q.bound(ArchiveField::Time, -inf, std::stod(argv[++i]));
+        } else if (arg == "--iff" && i + 1 < argc) {
+            q.iffMask = 0;
+            std::stringstream ss(argv[++i]);
+            std::string tok;
+            while (std::getline(ss, tok, ',')) {
+                auto iff = parseIFF(trim(tok));
+                if (!iff) throw std::runtime_error("Unknown IFF: " + tok);
+                q.iffMask |= static_cast<uint16_t>(1u << static_cast<unsigned>(*iff));
+            }
+        } else if (arg == "--range" && i + 1 < argc) {
+            parseBound(argv[++i], q, ArchiveField::Range);
+        } else if (arg == "--closing" && i + 1 < argc) {
+            parseBound(argv[++i], q, ArchiveField::Closing);
+        } else if (arg == "--alt" && i + 1 < argc) {
+            parseBound(argv[++i], q, ArchiveField::Altitude);
+        } else if (arg == "--rcs" && i + 1 < argc) {
+            parseBound(argv[++i], q, ArchiveField::Rcs);
+        } else if (arg == "--east" && i + 1 < argc) {
+            parseBound(argv[++i], q, ArchiveField::East);
+        } else if (arg == "--north" && i + 1 < argc) {
+            parseBound(argv[++i], q, ArchiveField::North);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<size_t>(std::stoull(argv[++i]));
+        } else if (arg == "--count") {
+            countOnly = true;
+        } else if (path.empty() && !arg.empty() && arg[0] != '-') {
+            path = arg;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (path.empty()) {
+        usage();
+        return 2;
+    }
+
+    Archive ar(path);
+    ArchiveScanStats st;
+    auto t0 = Clock::now();
+    auto rows = ar.scan(q, threads, &st);
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    if (countOnly) {
+        std::cout << rows.size() << "\n";
+    } else {
+        std::cout << "time_s,id,iff,range_km,closing_mps,altitude_m,rcs_m2,east_km,north_km,platform\n";
+        std::cout << std::setprecision(10);
+        for (const auto& u : rows) writeUpdate(std::cout, u);
+    }
+    std::cerr << "row groups: " << st.groups << " (" << st.skipped << " skipped by zone maps), rows scanned "
+              << st.rowsScanned << " of " << ar.rows() << ", matched " << st.matched << ", "
+              << std::fixed << std::setprecision(2) << ms << " ms\n";
+    return 0;
+}
+
+int asOf(int argc, char** argv) {
+    std::string path, profilePath;
+    std::optional<double> t;
+    size_t top = std::numeric_limits<size_t>::max();
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--profile" && i + 1 < argc) {
+            profilePath = argv[++i];
+        } else if (arg == "--top" && i + 1 < argc) {
+            top = static_cast<size_t>(std::stoull(argv[++i]));
+        } else if (path.empty() && !arg.empty() && arg[0] != '-') {
+            path = arg;
+        } else if (!t && isNumeric(arg)) {
+            t = std::stod(arg);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (path.empty() || !t) {
+        usage();
+        return 2;
+    }
+
+    Profile prof = profilePath.empty() ? Profile{} : loadProfile(profilePath);
+    Archive ar(path);
+    TrackStore store;
+    AsOfStats st;
+    auto t0 = Clock::now();
+    ar.restoreAt(*t, store, &st);
+    store.rescore(prof.weights);
+    Ranking ranking = store.rank();
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    std::vector<std::pair<Contact, double>> ranked;
+    ranked.reserve(ranking.size());
+    for (TrackHandle h : ranking) ranked.emplace_back(store.contact(h), store.score[h]);
+    printTable(ranked, top, nullptr, prof.thresholds);
+
+    std::cerr << "as of t=" << *t << ": ";
+    if (st.restored) std::cerr << "checkpoint t=" << st.checkpoint << " (" << st.restored << " tracks), ";
+    else std::cerr << "no checkpoint, ";
+    std::cerr << "replayed " << st.replayed << " updates, " << std::fixed
+              << std::setprecision(2) << ms << " ms\n";
+    return 0;
+}
+
+int report(int argc, char** argv) {
+    std::string path, profilePath;
+    double from = -std::numeric_limits<double>::infinity();
+    double to = std::numeric_limits<double>::infinity();
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t top = std::numeric_limits<size_t>::max();
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--profile" && i + 1 < argc) {
+            profilePath = argv[++i];
+        } else if (arg == "--from" && i + 1 < argc) {
+            from = std::stod(argv[++i]);
+        } else if (arg == "--to" && i + 1 < argc) {
+            to = std::stod(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<size_t>(std::stoull(argv[++i]));
+        } else if (arg == "--top" && i + 1 < argc) {
+            top = static_cast<size_t>(std::stoull(argv[++i]));
+        } else if (path.empty() && !arg.empty() && arg[0] != '-') {
+            path = arg;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (path.empty()) {
+        usage();
+        return 2;
+    }
+
+    Profile prof = profilePath.empty() ? Profile{} : loadProfile(profilePath);
+    Archive ar(path);
+    auto t0 = Clock::now();
+    auto rows = summarizeTracks(ar, prof.weights, prof.thresholds, threads, from, to);
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    printTrackSummaries(rows, top);
+    std::cerr << rows.size() << " tracks from " << ar.rows() << " updates on " << threads
+              << " threads, " << std::fixed << std::setprecision(2) << ms << " ms\n";
+    return 0;
+}
+
+} // namespace
+
+int runArchive(int argc, char** argv) {
+    const std::string cmd = argc > 1 ? argv[1] : "";
+    if (cmd == "build") return build(argc, argv);
+    if (cmd == "query") return query(argc, argv);
+    if (cmd == "asof") return asOf(argc, argv);
+    if (cmd == "report") return report(argc, argv);
+    usage();
+    return 2;
+}
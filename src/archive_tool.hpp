@@ -0,0 +1,8 @@
+#pragma once
+
+// -------------------- Archive Tool --------------------
+// "sentinelscore archive build|query|asof|report ...": write update CSVs
+// into a columnar archive, run filtered historical queries over it, rebuild
+// the ranking as it stood at a given time and summarize each track's
+// history. argv[0] is "archive".
+int runArchive(int argc, char** argv);
@@ -0,0 +1,118 @@
+#include "assets.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+#include "csv.hpp"
+
+std::vector<Asset> loadAssets(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Failed to open asset CSV: " + path);
+    }
+
+    std::vector<Asset> out;
+    std::string line;
+    while (std::getline(in, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        auto cols = splitCSV(line);
+        if (cols.size() < 3) {
+            std::cerr << "Skipping malformed asset row: " << line << "\n";
+            continue;
+        }
+        if (out.empty() && cols[1] == "east_km") continue; // header
+
+        out.push_back({cols[0], toDouble(cols[1], 0.0), toDouble(cols[2], 0.0)});
+    }
+    return out;
+}
+
+namespace {
+
+// Tile sizes: 4 double columns * 256 tracks = 8 KiB, comfortably inside L1
+// alongside the output rows for a tile of assets.
+constexpr size_t kTrackBlock = 256;
+constexpr size_t kAssetBlock = 16;
+
+} // namespace
+
+ScoreMatrix computeScoreMatrix(const std::vector<Contact>& contacts,
+                               const std::vector<Asset>& assets,
+                               const Weights& w) {
+    ScoreMatrix m;
+    m.tracks = contacts.size();
+    m.assets = assets.size();
+    m.scores.resize(m.tracks * m.assets);
+    m.ranges.resize(m.tracks * m.assets);
+
+    // SoA copy of the per-track inputs so the pair loop is branch-free.
+    // has_pos is folded into a 0/1 blend factor.
+    const size_t n = m.tracks;
+    std::vector<double> east(n), north(n), fixed(n), posMask(n), base(n);
+    for (size_t t = 0; t < n; ++t) {
+        const Contact& c = contacts[t];
+        east[t]    = c.east_km;
+        north[t]   = c.north_km;
+        fixed[t]   = c.range_km;
+        posMask[t] = c.has_pos ? 1.0 : 0.0;
+        base[t]    = scoreBase(c, w);
+    }
+
+    const double wr = w.w_range_inv;
+    for (size_t t0 = 0; t0 < n; t0 += kTrackBlock) {
+        const size_t t1 = std::min(n, t0 + kTrackBlock);
+        for (size_t a0 = 0; a0 < m.assets; a0 += kAssetBlock) {
+            const size_t a1 = std::min(m.assets, a0 + kAssetBlock);
+            for (size_t a = a0; a < a1; ++a) {
+                const double ae = assets[a].east_km;
+                const double an = assets[a].north_km;
+                double* __restrict rowS = m.scores.data() + a * n;
+                double* __restrict rowR = m.ranges.data() + a * n;
+                for (size_t t = t0; t < t1; ++t) {
+                    const double de = east[t] - ae;
+                    const double dn = north[t] - an;
+                    const double d  = std::sqrt(de * de + dn * dn);
+                    const double r  = posMask[t] * d + (1.0 - posMask[t]) * fixed[t];
+                    // Same cap as rangeTerm(), written as a select
+                    const double inv = (r > 0.05) ? (1.0 / r) : 20.0;
+                    rowR[t] = r;
+                    rowS[t] = wr * inv + base[t];
+                }
+            }
+        }
+    }
+    return m;
+}
+
+std::vector<size_t> rankForAsset(const ScoreMatrix& m, size_t a) {
+    std::vector<size_t> idx(m.tracks);
+    std::iota(idx.begin(), idx.end(), size_t{0});
+    const double* row = m.scores.data() + a * m.tracks;
+    std::stable_sort(idx.begin(), idx.end(),
+                     [row](size_t x, size_t y){ return row[x] > row[y]; });
+    return idx;
+}
+
+std::vector<MaxOverAssets> rankMaxOverAssets(const ScoreMatrix& m) {
+    std::vector<MaxOverAssets> out(m.tracks);
+    if (m.assets == 0) return {};
+
+    // Sweep asset rows in order so the reads stay sequential
+    for (size_t t = 0; t < m.tracks; ++t) out[t] = {t, 0, m.scores[t]};
+    for (size_t a = 1; a < m.assets; ++a) {
+        const double* row = m.scores.data() + a * m.tracks;
+        for (size_t t = 0; t < m.tracks; ++t) {
+            if (row[t] > out[t].score) out[t] = {t, a, row[t]};
+        }
+    }
+
+    std::stable_sort(out.begin(), out.end(),
+                     [](const auto& x, const auto& y){ return x.score > y.score; });
+    return out;
+}
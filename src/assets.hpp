@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "contact.hpp"
+#include "scoring.hpp"
+
+// -------------------- Defended Assets --------------------
+struct Asset {
+    std::string name;
+    double east_km;
+    double north_km;
+};
+
+// CSV columns (header optional): name, east_km, north_km
+std::vector<Asset> loadAssets(const std::string& path);
+
+// Tracks x assets scores, stored asset-major so each asset's column of
+// track scores is contiguous (score of track t against asset a is
+// at(a, t)). Tracks without a reported position keep their reported
+// range_km against every asset.
+struct ScoreMatrix {
+    size_t tracks = 0;
+    size_t assets = 0;
+    std::vector<double> scores;   // assets * tracks
+    std::vector<double> ranges;   // assets * tracks, km
+
+    double score(size_t a, size_t t) const { return scores[a * tracks + t]; }
+    double range(size_t a, size_t t) const { return ranges[a * tracks + t]; }
+};
+
+// One pass over all (track, asset) pairs. The range-independent part of
+// score() is computed once per track; the pair loop is blocked so a tile
+// of track columns stays in L1 while it is swept across a tile of assets.
+ScoreMatrix computeScoreMatrix(const std::vector<Contact>& contacts,
+                               const std::vector<Asset>& assets,
+                               const Weights& w);
+
+// Track indices sorted by descending score against asset a.
+std::vector<size_t> rankForAsset(const ScoreMatrix& m, size_t a);
+
+struct MaxOverAssets {
+    size_t track;
+    size_t asset;   // asset that produced the max
+    double score;
+};
+
+// Each track's worst-case (max) score over all assets, sorted descending.
+std::vector<MaxOverAssets> rankMaxOverAssets(const ScoreMatrix& m);
@@ -0,0 +1,171 @@
+#include "association.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include "common.hpp"
+
+namespace {
+
+constexpr uint32_t kTentative = 0x80000000u;
+
+struct Pair {
+    double d2;       // normalized distance squared, <= 1 inside the gate
+    uint32_t plot;
+    uint32_t cand;
+};
+
+} // namespace
+
+AssocStats& AssocStats::operator+=(const AssocStats& o) {
+    plots      += o.plots;
+    assigned   += o.assigned;
+    confirmed  += o.confirmed;
+    started    += o.started;
+    noPosition += o.noPosition;
+    candidates += o.candidates;
+    return *this;
+}
+
+PlotAssociator::PlotAssociator(AssocParams p) : p_(p) {}
+
+void PlotAssociator::buildGrid(const std::vector<Update>& plots) {
+    const double cell = 2.0 * p_.gate_km;
+    keyed_.clear();
+    bucketBits_ = 4;
+    while ((size_t{1} << bucketBits_) < 2 * plots.size()) ++bucketBits_;
+    for (size_t i = 0; i < plots.size(); ++i) {
+        const Contact& c = plots[i].c;
+        if (!c.has_pos) continue;
+        const uint32_t b = bucketOf(cellOf(c.east_km, cell), cellOf(c.north_km, cell), bucketBits_);
+        keyed_.push_back((static_cast<uint64_t>(b) << 32) | i);
+    }
+
+    // Counting sort by bucket
+    const size_t buckets = size_t{1} << bucketBits_;
+    start_.assign(buckets + 1, 0);
+    for (uint64_t k : keyed_) ++start_[(k >> 32) + 1];
+    for (size_t b = 1; b <= buckets; ++b) start_[b] += start_[b - 1];
+    grid_.resize(keyed_.size());
+    std::vector<uint32_t> fill(start_.begin(), start_.end() - 1);
+    for (uint64_t k : keyed_) {
+        const Contact& c = plots[static_cast<uint32_t>(k)].c;
+        grid_[fill[k >> 32]++] = { c.east_km, c.north_km, c.altitude_m, static_cast<uint32_t>(k), c.iff };
+    }
+}
+
+std::string PlotAssociator::nextId(const TrackStore& store) {
+    for (;;) {
+        std::ostringstream os;
+        os << "P" << std::setw(6) << std::setfill('0') << nextSerial_++;
+        if (!store.find(os.str())) return os.str();
+    }
+}
+
+std::vector<Update> PlotAssociator::associate(const TrackStore& store, const TrackMotion& motion,
+                                              const std::vector<Update>& plots, double t,
+                                              AssocStats* stats) {
+    AssocStats st;
+    st.plots = plots.size();
+
+    // Tentatives that never got a second plot
+    tentative_.erase(std::remove_if(tentative_.begin(), tentative_.end(),
+                                    [&](const Tentative& x) { return t - x.t > p_.tentativeTtl_s; }),
+                     tentative_.end());
+
+    buildGrid(plots);
+    for (const Update& u : plots) st.noPosition += !u.c.has_pos;
+
+    // Every gated pair: probe the 2 x 2 cells nearest each candidate
+    const double cell = 2.0 * p_.gate_km;
+    const double invGate2 = 1.0 / (p_.gate_km * p_.gate_km);
+    const double invAlt2 = 1.0 / (p_.gate_alt_m * p_.gate_alt_m);
+    std::vector<Pair> pairs;
+    auto probe = [&](uint32_t cand, double e, double n, double alt, IFF iff) {
+        ++st.candidates;
+        const double fx = e / cell, fy = n / cell;
+        const int64_t cx = static_cast<int64_t>(std::floor(fx));
+        const int64_t cy = static_cast<int64_t>(std::floor(fy));
+        const int64_t nx = fx - static_cast<double>(cx) < 0.5 ? cx - 1 : cx + 1;
+        const int64_t ny = fy - static_cast<double>(cy) < 0.5 ? cy - 1 : cy + 1;
+        for (int64_t x : { cx, nx }) {
+            for (int64_t y : { cy, ny }) {
+                const uint32_t b = bucketOf(x, y, bucketBits_);
+                for (uint32_t k = start_[b]; k < start_[b + 1]; ++k) {
+                    const GridPlot& g = grid_[k];
+                    const double de = g.e - e, dn = g.n - n, da = g.alt - alt;
+                    const double d2 = (de * de + dn * dn) * invGate2 + da * da * invAlt2;
+                    if (d2 <= 1.0 && iffCompatible(g.iff, iff)) pairs.push_back({ d2, g.plot, cand });
+                }
+            }
+        }
+    };
+    if (!keyed_.empty()) {
+        for (TrackHandle h = 0; h < store.size(); ++h) {
+            if (!store.has_pos[h] || t - store.last_seen[h] > p_.maxAge_s) continue;
+            double e = store.east_km[h], n = store.north_km[h];
+            if (motion.hasVelocity(h)) {
+                const double dt = t - store.last_seen[h];
+                e += motion.velE(h) * dt;
+                n += motion.velN(h) * dt;
+            }
+            probe(h, e, n, store.altitude_m[h], store.iff[h]);
+        }
+        for (size_t i = 0; i < tentative_.size(); ++i) {
+            const Contact& c = tentative_[i].c;
+            probe(kTentative | static_cast<uint32_t>(i), c.east_km, c.north_km, c.altitude_m, c.iff);
+        }
+    }
+
+    // Greedy global nearest neighbour. Cells sharing a bucket can list a
+    // pair twice; the repeat finds the plot already used.
+    std::sort(pairs.begin(), pairs.end(), [](const Pair& a, const Pair& b) {
+        if (a.d2 != b.d2) return a.d2 < b.d2;
+        return a.plot != b.plot ? a.plot < b.plot : a.cand < b.cand;
+    });
+    if (taken_.size() < store.size()) taken_.resize(store.size(), 0);
+    std::vector<uint8_t> plotUsed(plots.size(), 0);
+    std::vector<uint8_t> tentUsed(tentative_.size(), 0);
+    std::vector<TrackHandle> takenHandles;
+    std::vector<Update> out;
+
+    for (const Pair& pr : pairs) {
+        if (plotUsed[pr.plot]) continue;
+        Update u = plots[pr.plot];
+        if (pr.cand & kTentative) {
+            const uint32_t ti = pr.cand & ~kTentative;
+            if (tentUsed[ti]) continue;
+            tentUsed[ti] = 1;
+            u.c.id = nextId(store);
+            if (iffSide(u.c.iff) == IffSide::Undetermined) u.c.iff = tentative_[ti].c.iff;
+            ++st.confirmed;
+        } else {
+            if (taken_[pr.cand]) continue;
+            taken_[pr.cand] = 1;
+            takenHandles.push_back(pr.cand);
+            u.c.id = store.id[pr.cand];
+            if (iffSide(u.c.iff) == IffSide::Undetermined) u.c.iff = store.iff[pr.cand];
+            ++st.assigned;
+        }
+        plotUsed[pr.plot] = 1;
+        out.push_back(std::move(u));
+    }
+    for (TrackHandle h : takenHandles) taken_[h] = 0;
+
+    // Confirmed tentatives leave; unassigned plots start new ones
+    size_t keep = 0;
+    for (size_t i = 0; i < tentative_.size(); ++i) {
+        if (!tentUsed[i]) tentative_[keep++] = std::move(tentative_[i]);
+    }
+    tentative_.resize(keep);
+    for (size_t i = 0; i < plots.size(); ++i) {
+        if (plotUsed[i] || !plots[i].c.has_pos) continue;
+        tentative_.push_back({ plots[i].c, plots[i].t });
+        ++st.started;
+    }
+
+    if (stats) *stats = st;
+    return out;
+}
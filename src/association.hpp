@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "contact.hpp"
+#include "stream.hpp"
+#include "track_filter.hpp"
+#include "track_store.hpp"
+
+// -------------------- Plot Association --------------------
+// Some sensors report anonymous plots: updates with an empty id. Each scan
+// they are matched to tracks by position. The scan's plots, the smaller
+// side, are bucketed into a hashed grid of cells twice the gate size.
+// Candidate tracks are swept in handle order: the store tracks
+// with a position seen within maxAge_s, predicted to the scan time, then
+// the tentative tracks. A gate can only overlap the 2 x 2 cells around
+// the nearest cell corner, so each track makes four probes. Gated
+// (plot, track) pairs are assigned greedily, nearest first. A plot that
+// gates with nothing starts a tentative track, which joins the store as
+// P<n> when a second plot lands on it.
+struct AssocParams {
+    double gate_km = 2.0;          // horizontal gate radius
+    double gate_alt_m = 1500.0;    // altitude gate
+    double maxAge_s = 60.0;        // older tracks are not candidates
+    double tentativeTtl_s = 10.0;  // unconfirmed tentatives expire after this
+};
+
+struct AssocStats {
+    size_t plots = 0;
+    size_t assigned = 0;     // to existing tracks
+    size_t confirmed = 0;    // tentative tracks promoted to the store
+    size_t started = 0;      // new tentative tracks
+    size_t noPosition = 0;   // plots without east/north, dropped
+    size_t candidates = 0;   // tracks swept
+
+    AssocStats& operator+=(const AssocStats& o);
+};
+
+// True for an update without a track id
+inline bool isPlot(const Update& u) { return u.c.id.empty(); }
+
+class PlotAssociator {
+public:
+    explicit PlotAssociator(AssocParams p = {});
+
+    // Resolve the plots of the scan at time t, predicting tracks with the
+    // given motion. Returns updates named after the store track each plot
+    // was assigned to (or a newly confirmed one), ready for applyBatch; the
+    // other plots feed tentative tracks.
+    std::vector<Update> associate(const TrackStore& store, const TrackMotion& motion,
+                                  const std::vector<Update>& plots, double t,
+                                  AssocStats* stats = nullptr);
+
+    size_t tentative() const { return tentative_.size(); }
+
+private:
+    struct Tentative {
+        Contact c;
+        double t;
+    };
+
+    // Grid entries are probed at random, so each is kept in one 32-byte
+    // record: a bucket hit costs one cache line, not one per column.
+    struct GridPlot {
+        double e, n, alt;
+        uint32_t plot;
+        IFF iff;
+    };
+
+    void buildGrid(const std::vector<Update>& plots);
+    std::string nextId(const TrackStore& store);
+
+    AssocParams p_;
+    uint64_t nextSerial_ = 1;
+    std::vector<Tentative> tentative_;
+
+    // Plot grid: plots in bucket order, bucket b's are
+    // [start_[b], start_[b + 1])
+    unsigned bucketBits_ = 0;
+    std::vector<uint32_t> start_;
+    std::vector<uint64_t> keyed_;      // bucket << 32 | plot, unsorted
+    std::vector<GridPlot> grid_;
+    std::vector<uint8_t> taken_;       // by handle, cleared after each scan
+};
@@ -0,0 +1,824 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "association.hpp"
+#include "concurrent_store.hpp"
+#include "dedup.hpp"
+#include "geodesy.hpp"
+#include "grouping.hpp"
+#include "hugepages.hpp"
+#include "numa.hpp"
+#include "perf_counters.hpp"
+#include "terrain.hpp"
+#include "track_filter.hpp"
+#include "track_store.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// --name value pairs after the benchmark name
+std::map<std::string, std::string> parseArgs(int argc, char** argv, int first) {
+    std::map<std::string, std::string> out;
+    for (int i = first; i + 1 < argc; i += 2) {
+        std::string k = argv[i];
+        if (k.rfind("--", 0) == 0) out[k.substr(2)] = argv[i + 1];
+    }
+    return out;
+}
+
+size_t argSize(const std::map<std::string, std::string>& a, const std::string& k, size_t def) {
+    auto it = a.find(k);
+    return it == a.end() ? def : static_cast<size_t>(std::stoull(it->second));
+}
+
+std::vector<size_t> argList(const std::map<std::string, std::string>& a, const std::string& k,
+                            const std::string& def) {
+    auto it = a.find(k);
+    std::stringstream ss(it == a.end() ? def : it->second);
+    std::vector<size_t> out;
+    std::string tok;
+    while (std::getline(ss, tok, ',')) out.push_back(static_cast<size_t>(std::stoull(tok)));
+    return out;
+}
+
+// Small, fast PRNG so update generation never dominates
+struct XorShift {
+    uint64_t s;
+    explicit XorShift(uint64_t seed) : s(seed * 0x9e3779b97f4a7c15ull + 1) {}
+    uint64_t next() { s ^= s << 13; s ^= s >> 7; s ^= s << 17; return s; }
+};
+
+std::string trackId(size_t i) {
+    std::ostringstream os;
+    os << "T" << std::setw(7) << std::setfill('0') << i;
+    return os.str();
+}
+
+Contact sampleContact(const std::string& id, uint64_t r) {
+    Contact c { id, IFF::Foe, 5.0 + (r % 950) / 10.0, static_cast<double>(r % 400),
+                static_cast<double>(r % 12000), 1.0 + (r % 50) / 10.0 };
+    return c;
+}
+
+// Run fn(thread index) on n threads released together; returns wall seconds.
+template <class Fn>
+double runThreads(size_t n, Fn fn) {
+    std::atomic<size_t> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> ts;
+    for (size_t t = 0; t < n; ++t) {
+        ts.emplace_back([&, t]{
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            fn(t);
+        });
+    }
+    while (ready.load() < n) std::this_thread::yield();
+    auto t0 = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& th : ts) th.join();
+    return secondsSince(t0);
+}
+
+// -------------------- bench ingest --------------------
+// Parallel upserts into ConcurrentTrackStore vs one mutex around TrackStore.
+int benchIngest(const std::map<std::string, std::string>& a) {
+    const size_t tracks  = argSize(a, "tracks", 100000);
+    const size_t updates = argSize(a, "updates", 4000000);
+    const unsigned bits  = static_cast<unsigned>(argSize(a, "shard-bits", 8));
+    const auto threads   = argList(a, "threads", "1,2,4,8,16,32");
+
+    std::vector<std::string> ids(tracks);
+    std::vector<TrackKey> keys(tracks);
+    for (size_t i = 0; i < tracks; ++i) ids[i] = trackId(i);
+    for (size_t i = 0; i < tracks; ++i) keys[i] = ConcurrentTrackStore::intern(ids[i]);
+
+    std::cout << "bench ingest: " << tracks << " tracks, " << updates << " updates, "
+              << (1u << bits) << " shards, " << std::thread::hardware_concurrency()
+              << " hardware threads\n";
+    std::cout << std::left << std::setw(10) << "THREADS" << std::setw(18) << "SHARDED(Mupd/s)"
+              << std::setw(10) << "SPEEDUP" << "ONE-LOCK(Mupd/s)\n";
+
+    double base = 0.0;
+    for (size_t n : threads) {
+        if (n == 0) continue;
+        const size_t per = updates / n;
+
+        // Pre-generate each thread's track indices outside the timed region
+        std::vector<std::vector<uint32_t>> work(n);
+        for (size_t t = 0; t < n; ++t) {
+            XorShift rng(t + 1);
+            work[t].resize(per);
+            for (auto& w : work[t]) w = static_cast<uint32_t>(rng.next() % tracks);
+        }
+
+        ConcurrentTrackStore cs(bits);
+        for (size_t i = 0; i < tracks; ++i) cs.upsert(keys[i], sampleContact(ids[i], i), 0.0);
+        double secs = runThreads(n, [&](size_t t) {
+            XorShift rng(t + 100);
+            for (uint32_t i : work[t]) cs.upsert(keys[i], sampleContact(ids[i], rng.next()), 1.0);
+        });
+        double rate = per * n / secs / 1e6;
+        if (base == 0.0) base = rate;
+
+        TrackStore ts;
+        std::mutex mu;
+        for (size_t i = 0; i < tracks; ++i) ts.upsert(sampleContact(ids[i], i), 0.0);
+        double lockSecs = runThreads(n, [&](size_t t) {
+            XorShift rng(t + 100);
+            for (uint32_t i : work[t]) {
+                Contact c = sampleContact(ids[i], rng.next());
+                std::lock_guard<std::mutex> lk(mu);
+                ts.upsert(c, 1.0);
+            }
+        });
+
+        std::cout << std::left << std::fixed << std::setprecision(2)
+                  << std::setw(10) << n << std::setw(18) << rate
+                  << std::setw(10) << rate / base << per * n / lockSecs / 1e6 << "\n";
+    }
+    return 0;
+}
+
+// -------------------- bench batch --------------------
+// One-at-a-time upsert + rescore in arrival order vs applyBatch.
+int benchBatch(const std::map<std::string, std::string>& a) {
+    const size_t tracks  = argSize(a, "tracks", 1000000);
+    const size_t updates = argSize(a, "updates", 2000000);
+    const size_t batch   = std::max<size_t>(1, argSize(a, "batch", 65536));
+    const Weights w{};
+
+    std::vector<std::string> ids(tracks);
+    for (size_t i = 0; i < tracks; ++i) ids[i] = trackId(i);
+
+    // Random tracks, with some repeats inside a batch as on a busy feed
+    XorShift rng(7);
+    std::vector<Update> stream(updates);
+    for (size_t i = 0; i < updates; ++i) {
+        uint64_t r = rng.next();
+        stream[i] = { static_cast<double>(i), sampleContact(ids[r % tracks], r >> 20) };
+    }
+
+    auto prefill = [&](TrackStore& ts) {
+        for (size_t i = 0; i < tracks; ++i) ts.upsert(sampleContact(ids[i], i), 0.0);
+        ts.rescore(w);
+    };
+
+    std::cout << "bench batch: " << tracks << " tracks, " << updates << " updates, batch "
+              << batch << "\n";
+    std::cout << std::left << std::setw(16) << "MODE" << std::setw(14) << "NS/UPDATE"
+              << std::setw(20) << "CACHE-MISS/UPDATE" << "DTLB-MISS/UPDATE\n";
+
+    auto report = [&](const char* mode, double secs, const PerfCounters& pc) {
+        std::cout << std::left << std::setw(16) << mode << std::setw(14) << std::fixed
+                  << std::setprecision(1) << secs * 1e9 / updates << std::setw(20)
+                  << pc.perUnit(PerfCounters::Event::CacheMisses, updates)
+                  << pc.perUnit(PerfCounters::Event::DtlbLoadMisses, updates) << "\n";
+    };
+    const std::vector<PerfCounters::Event> events = {
+        PerfCounters::Event::CacheMisses, PerfCounters::Event::DtlbLoadMisses };
+
+    {
+        TrackStore ts;
+        prefill(ts);
+        PerfCounters pc(events);
+        pc.start();
+        auto t0 = Clock::now();
+        for (const auto& u : stream) {
+            TrackHandle h = ts.upsert(u.c, u.t);
+            ts.setScore(h, scoreFromFeatures(ts.features(h), w));
+        }
+        double secs = secondsSince(t0);
+        pc.stop();
+        report("one-at-a-time", secs, pc);
+    }
+    {
+        TrackStore ts;
+        prefill(ts);
+        std::vector<std::vector<Update>> batches;
+        for (size_t i = 0; i < updates; i += batch) {
+            batches.emplace_back(stream.begin() + i, stream.begin() + std::min(updates, i + batch));
+        }
+        TrackStore::BatchStats st;
+        size_t applied = 0;
+        PerfCounters pc(events);
+        pc.start();
+        auto t0 = Clock::now();
+        for (const auto& b : batches) {
+            ts.applyBatch(b, w, &st);
+            applied += st.applied;
+        }
+        double secs = secondsSince(t0);
+        pc.stop();
+        report("batched", secs, pc);
+        std::cout << "  (" << updates - applied << " duplicate updates collapsed)\n";
+    }
+    return 0;
+}
+
+// -------------------- bench numa --------------------
+// Parallel score + top-K over one centrally allocated store (all pages
+// first-touched by the main thread) vs node-local partitions.
+int benchNuma(const std::map<std::string, std::string>& a) {
+    const size_t tracks = argSize(a, "tracks", 4000000);
+    const size_t k      = argSize(a, "k", 100);
+    const size_t iters  = std::max<size_t>(1, argSize(a, "iters", 10));
+    const auto perNode  = argList(a, "threads-per-node", "1,2,4,8");
+    const Weights w{};
+
+    const NumaTopology topo = NumaTopology::detect();
+    std::cout << "bench numa: " << tracks << " tracks, top " << k << ", " << topo.nodes()
+              << " node(s)";
+    for (size_t n = 0; n < topo.nodes(); ++n) std::cout << (n ? ", " : ": ") << topo.cpus[n].size() << " cpus";
+    std::cout << "\n";
+    if (topo.nodes() < 2) std::cout << "  (single node: both layouts are local, expect parity)\n";
+
+    TrackStore central;
+    {
+        XorShift rng(11);
+        for (size_t i = 0; i < tracks; ++i) central.upsert(sampleContact(trackId(i), rng.next()), 0.0);
+    }
+
+    std::cout << std::left << std::setw(10) << "THREADS" << std::setw(18) << "CENTRAL(ms/pass)"
+              << std::setw(18) << "NUMA(ms/pass)" << "SPEEDUP\n";
+    for (size_t t : perNode) {
+        if (t == 0) continue;
+        PinnedPool pool(topo, t);
+        const size_t workers = pool.nodes() * t;
+
+        // Central layout: same pinned workers, striped over the one store
+        std::vector<std::vector<std::pair<double, TrackHandle>>> local(workers);
+        auto t0 = Clock::now();
+        for (size_t it = 0; it < iters; ++it) {
+            pool.run([&](size_t node, size_t worker, size_t nw) {
+                const size_t idx = node * nw + worker;
+                const size_t lo = tracks * idx / workers, hi = tracks * (idx + 1) / workers;
+                auto& top = local[idx];
+                top.clear();
+                for (size_t h = lo; h < hi; ++h) {
+                    double s = scoreFromFeatures(central.features(static_cast<TrackHandle>(h)), w);
+                    central.score[h] = s;
+                    top.emplace_back(s, static_cast<TrackHandle>(h));
+                    if (top.size() >= 2 * k) keepTopK(top, k);
+                }
+                keepTopK(top, k);
+            });
+            std::vector<std::pair<double, TrackHandle>> all;
+            for (auto& l : local) all.insert(all.end(), l.begin(), l.end());
+            keepTopK(all, k);
+        }
+        double centralMs = secondsSince(t0) * 1e3 / iters;
+
+        NumaScorer ns(pool);
+        ns.load(central);
+        t0 = Clock::now();
+        for (size_t it = 0; it < iters; ++it) ns.scoreTopK(w, k);
+        double numaMs = secondsSince(t0) * 1e3 / iters;
+
+        std::cout << std::left << std::fixed << std::setprecision(2) << std::setw(10) << workers
+                  << std::setw(18) << centralMs << std::setw(18) << numaMs
+                  << centralMs / numaMs << "\n";
+    }
+    return 0;
+}
+
+// -------------------- bench tlb --------------------
+// Random-access rescore and ranking over the store's columns with plain vs
+// huge-page backing.
+int benchTlb(const std::map<std::string, std::string>& a) {
+    const size_t tracks  = argSize(a, "tracks", 4000000);
+    const size_t lookups = argSize(a, "lookups", 4000000);
+    const Weights w{};
+
+    XorShift rng(13);
+    std::vector<TrackHandle> handles(lookups);
+    for (auto& h : handles) h = static_cast<TrackHandle>(rng.next() % tracks);
+
+    std::cout << "bench tlb: " << tracks << " tracks, " << lookups << " random rescores\n";
+    std::cout << std::left << std::setw(8) << "PAGES" << std::setw(26) << "BACKING(MiB tlb/thp/4k)"
+              << std::setw(12) << "ANONHUGE" << std::setw(16) << "RESCORE(ns/trk)"
+              << std::setw(18) << "DTLB-MISS/TRACK" << "RANK(ms)\n";
+
+    const std::vector<PerfCounters::Event> events = { PerfCounters::Event::DtlbLoadMisses };
+    const HugePages saved = hugePages();
+    for (HugePages mode : { HugePages::Off, HugePages::On }) {
+        setHugePages(mode);
+        const long hugeKb0 = anonHugePagesKb();
+        TrackStore ts;
+        for (size_t i = 0; i < tracks; ++i) ts.upsert(sampleContact(trackId(i), rng.next()), 0.0);
+        ts.rescore(w);
+
+        PerfCounters pc(events);
+        pc.start();
+        auto t0 = Clock::now();
+        ts.rescore(w, handles);
+        double secs = secondsSince(t0);
+        pc.stop();
+
+        t0 = Clock::now();
+        Ranking r = ts.rank();
+        double rankSecs = secondsSince(t0);
+
+        const HugePageStats st = hugePageStats();
+        const long hugeKb = anonHugePagesKb();
+        std::ostringstream backing, anon;
+        backing << (st.hugetlb >> 20) << "/" << (st.thp >> 20) << "/" << (st.plain >> 20);
+        if (hugeKb < 0 || hugeKb0 < 0) anon << "n/a";
+        else anon << (hugeKb - hugeKb0) / 1024 << "MiB";
+        std::cout << std::left << std::setw(8) << (mode == HugePages::On ? "huge" : "4k")
+                  << std::setw(26) << backing.str() << std::setw(12) << anon.str()
+                  << std::setw(16) << std::fixed << std::setprecision(1) << secs * 1e9 / lookups
+                  << std::setw(18) << pc.perUnit(PerfCounters::Event::DtlbLoadMisses, lookups)
+                  << rankSecs * 1e3 << "\n";
+    }
+    setHugePages(saved);
+    return 0;
+}
+
+// -------------------- bench filter --------------------
+// Filter throughput: every track gets one noisy range/altitude report per
+// cycle. Also reports the range error before and after filtering.
+int benchFilter(const std::map<std::string, std::string>& a) {
+    const size_t tracks = argSize(a, "tracks", 1000000);
+    const size_t cycles = argSize(a, "cycles", 20);
+
+    // Truth: constant closing speed and climb rate per track
+    XorShift rng(29);
+    std::vector<double> r0(tracks), rv(tracks), a0(tracks), av(tracks);
+    for (size_t i = 0; i < tracks; ++i) {
+        r0[i] = 50.0 + (rng.next() % 1000) / 10.0;
+        rv[i] = -((rng.next() % 400) / 1000.0);   // km/s, closing
+        a0[i] = static_cast<double>(rng.next() % 12000);
+        av[i] = (static_cast<double>(rng.next() % 40) - 20.0);
+    }
+    // Uniform noise of the given half-width
+    auto noise = [&](double half) {
+        return half * ((rng.next() % 2001) / 1000.0 - 1.0);
+    };
+
+    std::vector<TrackHandle> hs(tracks);
+    for (size_t i = 0; i < tracks; ++i) hs[i] = static_cast<TrackHandle>(i);
+
+    std::cout << "bench filter: " << tracks << " tracks x " << cycles << " cycles\n";
+    std::cout << std::left << std::setw(10) << "FILTER" << std::setw(14) << "MUPDATES/S"
+              << std::setw(16) << "NS/UPDATE" << std::setw(16) << "RAW RMS(m)" << "FILTERED RMS(m)\n";
+
+    for (FilterKind kind : { FilterKind::AlphaBeta, FilterKind::Kalman }) {
+        TrackSmoother f(kind);
+        std::vector<double> t(tracks), r(tracks), alt(tracks);
+        double secs = 0.0, rawSq = 0.0, filtSq = 0.0;
+        size_t measured = 0;
+        for (size_t c = 0; c < cycles; ++c) {
+            const double now = static_cast<double>(c);
+            for (size_t i = 0; i < tracks; ++i) {
+                t[i] = now;
+                r[i] = r0[i] + rv[i] * now + noise(0.1);
+                alt[i] = a0[i] + av[i] * now + noise(50.0);
+            }
+            // The error is measured once the filters have settled
+            const bool measure = c >= cycles / 2;
+            if (measure) {
+                for (size_t i = 0; i < tracks; ++i) {
+                    const double e = r[i] - (r0[i] + rv[i] * now);
+                    rawSq += e * e;
+                }
+            }
+            auto t0 = Clock::now();
+            f.step(tracks, hs.data(), t.data(), r.data(), alt.data());
+            secs += secondsSince(t0);
+            if (measure) {
+                for (size_t i = 0; i < tracks; ++i) {
+                    const double e = r[i] - (r0[i] + rv[i] * now);
+                    filtSq += e * e;
+                }
+                measured += tracks;
+            }
+        }
+        const double updates = static_cast<double>(tracks) * cycles;
+        std::cout << std::left << std::setw(10) << (kind == FilterKind::Kalman ? "kalman" : "ab")
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(14) << updates / secs / 1e6
+                  << std::setw(16) << secs * 1e9 / updates
+                  << std::setw(16) << 1000.0 * std::sqrt(rawSq / std::max<size_t>(measured, 1))
+                  << 1000.0 * std::sqrt(filtSq / std::max<size_t>(measured, 1)) << "\n";
+    }
+    return 0;
+}
+
+// -------------------- bench assoc --------------------
+// Anonymous plots from random tracks (plus clutter) associated against the
+// whole picture, one scan per second of stream time.
+int benchAssoc(const std::map<std::string, std::string>& a) {
+    const size_t tracks = argSize(a, "tracks", 1000000);
+    const size_t plots  = argSize(a, "plots", 100000);
+    const size_t scans  = argSize(a, "scans", 5);
+    const double side = 2.0 * std::sqrt(static_cast<double>(tracks));   // ~1 track per 4 km^2
+    const Weights w{};
+
+    XorShift rng(41);
+    auto uniform = [&](double lo, double hi) {
+        return lo + (hi - lo) * static_cast<double>(rng.next() % 1000000) / 1e6;
+    };
+    std::vector<double> e0(tracks), n0(tracks), ve(tracks), vn(tracks), alt(tracks);
+    for (size_t i = 0; i < tracks; ++i) {
+        e0[i] = uniform(0.0, side);
+        n0[i] = uniform(0.0, side);
+        ve[i] = uniform(-0.25, 0.25);
+        vn[i] = uniform(-0.25, 0.25);
+        alt[i] = uniform(500.0, 12000.0);
+    }
+    auto truth = [&](size_t i, double t) {
+        Contact c = sampleContact(trackId(i), i);
+        c.iff = IFF::Unknown;
+        c.altitude_m = alt[i];
+        c.has_pos = true;
+        c.east_km = e0[i] + ve[i] * t;
+        c.north_km = n0[i] + vn[i] * t;
+        return c;
+    };
+
+    // Two identified reports per track give each a velocity
+    TrackStore store;
+    TrackMotion motion;
+    PlotAssociator assoc;
+    for (double t : { 0.0, 1.0 }) {
+        std::vector<Update> batch;
+        batch.reserve(tracks);
+        for (size_t i = 0; i < tracks; ++i) batch.push_back({ t, truth(i, t) });
+        motion.observe(store, store.applyBatch(batch, w));
+    }
+
+    std::cout << "bench assoc: " << tracks << " tracks, " << plots << " plots/scan (10% clutter), "
+              << scans << " scans\n";
+    std::cout << std::left << std::setw(8) << "SCAN" << std::setw(14) << "ASSOC(ms)"
+              << std::setw(14) << "CANDIDATES" << std::setw(12) << "ASSIGNED" << std::setw(12)
+              << "TENTATIVE" << "CORRECT\n";
+    for (size_t s = 0; s < scans; ++s) {
+        const double t = 2.0 + static_cast<double>(s);
+        std::vector<Update> batch;
+        std::vector<size_t> source(plots);
+        for (size_t p = 0; p < plots; ++p) {
+            const bool clutter = rng.next() % 10 == 0;
+            const size_t i = rng.next() % tracks;
+            Contact c = truth(i, t);
+            c.id.clear();
+            c.east_km  += clutter ? uniform(-side, side) : uniform(-0.3, 0.3);
+            c.north_km += clutter ? uniform(-side, side) : uniform(-0.3, 0.3);
+            c.altitude_m += uniform(-100.0, 100.0);
+            source[p] = clutter ? tracks : i;
+            batch.push_back({ t, c });
+        }
+
+        AssocStats st;
+        auto t0 = Clock::now();
+        auto named = assoc.associate(store, motion, batch, t, &st);
+        const double secs = secondsSince(t0);
+
+        // Plots come back in no particular order; match them by position
+        size_t correct = 0, fromTracks = 0;
+        for (size_t p = 0; p < plots; ++p) fromTracks += source[p] < tracks;
+        std::map<std::pair<double, double>, size_t> where;
+        for (size_t p = 0; p < plots; ++p) where[{ batch[p].c.east_km, batch[p].c.north_km }] = source[p];
+        for (const Update& u : named) {
+            const size_t src = where[{ u.c.east_km, u.c.north_km }];
+            if (src < tracks && u.c.id == trackId(src)) ++correct;
+        }
+        motion.observe(store, store.applyBatch(named, w));
+
+        std::cout << std::left << std::setw(8) << s << std::fixed << std::setprecision(1)
+                  << std::setw(14) << secs * 1e3 << std::setw(14) << st.candidates
+                  << std::setw(12) << st.assigned << std::setw(12) << assoc.tentative()
+                  << 100.0 * correct / std::max<size_t>(fromTracks, 1) << "%\n";
+    }
+    return 0;
+}
+
+// -------------------- bench dedup --------------------
+// Cross-id dedup pass over growing pictures where 10% of the aircraft are
+// also reported under a second id.
+int benchDedup(const std::map<std::string, std::string>& a) {
+    const auto sizes = argList(a, "tracks", "125000,250000,500000,1000000");
+    const size_t reps = argSize(a, "reps", 3);
+    const Weights w{};
+
+    std::cout << "bench dedup: 10% of aircraft reported twice\n";
+    std::cout << std::left << std::setw(12) << "TRACKS" << std::setw(12) << "RUN(ms)"
+              << std::setw(14) << "NS/TRACK" << std::setw(12) << "INJECTED" << "GROUPS\n";
+    for (size_t tracks : sizes) {
+        XorShift rng(53);
+        auto uniform = [&](double lo, double hi) {
+            return lo + (hi - lo) * static_cast<double>(rng.next() % 1000000) / 1e6;
+        };
+        const double side = 4.0 * std::sqrt(static_cast<double>(tracks));
+        TrackStore store;
+        size_t injected = 0;
+        for (size_t i = 0; store.size() < tracks; ++i) {
+            Contact c = sampleContact(trackId(i), rng.next());
+            c.iff = IFF::Unknown;
+            c.has_pos = true;
+            c.east_km = uniform(0.0, side);
+            c.north_km = uniform(0.0, side);
+            store.upsert(c, 0.0);
+            if (rng.next() % 10 == 0 && store.size() < tracks) {
+                c.id = "X" + c.id;
+                c.east_km += uniform(-0.3, 0.3);
+                c.north_km += uniform(-0.3, 0.3);
+                c.altitude_m += uniform(-100.0, 100.0);
+                c.closing_mps += uniform(-20.0, 20.0);
+                store.upsert(c, 0.0);
+                ++injected;
+            }
+        }
+        store.rescore(w);
+
+        TrackDeduplicator dd;
+        double best = 1e30;
+        for (size_t r = 0; r < reps; ++r) {
+            auto t0 = Clock::now();
+            dd.run(store, 0.0);
+            best = std::min(best, secondsSince(t0));
+        }
+        std::cout << std::left << std::setw(12) << tracks << std::fixed << std::setprecision(1)
+                  << std::setw(12) << best * 1e3 << std::setw(14) << best * 1e9 / tracks
+                  << std::setw(12) << injected << dd.groups() << "\n";
+    }
+    return 0;
+}
+
+// -------------------- bench group --------------------
+// Grouping pass over a picture where about a third of the tracks fly in
+// formations of 3 to 6, the rest alone.
+int benchGroup(const std::map<std::string, std::string>& a) {
+    const size_t tracks = argSize(a, "tracks", 100000);
+    const size_t reps = argSize(a, "reps", 5);
+    const auto threads = argList(a, "threads", "1,2,4");
+    const Weights w{};
+
+    XorShift rng(67);
+    auto uniform = [&](double lo, double hi) {
+        return lo + (hi - lo) * static_cast<double>(rng.next() % 1000000) / 1e6;
+    };
+    const double side = 10.0 * std::sqrt(static_cast<double>(tracks));   // ~1 track per 100 km^2
+
+    // Two reports a second apart give every track a velocity
+    struct Truth { double e, n, ve, vn; };
+    std::vector<Truth> truth;
+    size_t formations = 0;
+    while (truth.size() < tracks) {
+        const Truth lead { uniform(0.0, side), uniform(0.0, side), uniform(-0.3, 0.3), uniform(-0.3, 0.3) };
+        const size_t size = rng.next() % 3 == 0 ? 3 + rng.next() % 4 : 1;
+        formations += size > 1;
+        for (size_t m = 0; m < size && truth.size() < tracks; ++m) {
+            truth.push_back({ lead.e + uniform(-1.0, 1.0), lead.n + uniform(-1.0, 1.0),
+                              lead.ve + uniform(-0.01, 0.01), lead.vn + uniform(-0.01, 0.01) });
+        }
+    }
+    TrackStore store;
+    TrackMotion motion;
+    for (double t : { 0.0, 1.0 }) {
+        std::vector<Update> batch;
+        for (size_t i = 0; i < tracks; ++i) {
+            Contact c = sampleContact(trackId(i), i);
+            c.has_pos = true;
+            c.east_km = truth[i].e + truth[i].ve * t;
+            c.north_km = truth[i].n + truth[i].vn * t;
+            batch.push_back({ t, c });
+        }
+        motion.observe(store, store.applyBatch(batch, w));
+    }
+
+    std::cout << "bench group: " << tracks << " tracks, " << formations << " formations\n";
+    std::cout << std::left << std::setw(10) << "THREADS" << std::setw(12) << "RUN(ms)"
+              << std::setw(12) << "GROUPS" << "GROUPED TRACKS\n";
+    for (size_t nt : threads) {
+        TrackGrouper g(GroupParams{}, nt);
+        double best = 1e30;
+        for (size_t r = 0; r < reps; ++r) {
+            auto t0 = Clock::now();
+            g.run(store, motion, 1.0);
+            best = std::min(best, secondsSince(t0));
+        }
+        size_t grouped = 0;
+        for (const auto& grp : g.groups()) grouped += grp.members.size();
+        std::cout << std::left << std::setw(10) << nt << std::fixed << std::setprecision(2)
+                  << std::setw(12) << best * 1e3 << std::setw(12) << g.groups().size() << grouped << "\n";
+    }
+    return 0;
+}
+
+// -------------------- bench geo --------------------
+// Geodetic to local conversion of points scattered up to ~500 km around an
+// origin: the batch kernel against the same formulas with libm trig, plus
+// the fast sine/cosine error over [-pi, pi].
+int benchGeo(const std::map<std::string, std::string>& a) {
+    const size_t points = argSize(a, "points", 1000000);
+    const size_t reps = std::max<size_t>(1, argSize(a, "reps", 5));
+    const double lat0 = 52.0, lon0 = 179.0;   // longitudes wrap across the antimeridian
+    const LocalFrame frame(lat0, lon0, 100.0);
+
+    XorShift rng(71);
+    auto uniform = [&](double lo, double hi) {
+        return lo + (hi - lo) * static_cast<double>(rng.next() % 1000000) / 1e6;
+    };
+    std::vector<double> lat(points), lon(points), alt(points);
+    for (size_t i = 0; i < points; ++i) {
+        lat[i] = lat0 + uniform(-4.5, 4.5);
+        lon[i] = lon0 + uniform(-7.0, 7.0);
+        if (lon[i] > 180.0) lon[i] -= 360.0;
+        alt[i] = uniform(0.0, 15000.0);
+    }
+
+    // Reference: WGS-84 to ECEF to ENU with libm
+    constexpr double kA = 6378137.0, kE2 = 6.69437999014e-3, kDeg = 3.14159265358979323846 / 180.0;
+    auto ecef = [&](double la, double lo, double h, double (&x)[3]) {
+        const double sp = std::sin(la * kDeg), nu = kA / std::sqrt(1.0 - kE2 * sp * sp);
+        x[0] = (nu + h) * std::cos(la * kDeg) * std::cos(lo * kDeg);
+        x[1] = (nu + h) * std::cos(la * kDeg) * std::sin(lo * kDeg);
+        x[2] = (nu * (1.0 - kE2) + h) * sp;
+    };
+    std::vector<double> refE(points), refN(points), refR(points);
+    auto reference = [&]() {
+        double o[3], p[3];
+        ecef(lat0, lon0, 100.0, o);
+        const double sl = std::sin(lat0 * kDeg), cl = std::cos(lat0 * kDeg);
+        const double so = std::sin(lon0 * kDeg), co = std::cos(lon0 * kDeg);
+        for (size_t i = 0; i < points; ++i) {
+            ecef(lat[i], lon[i], alt[i], p);
+            const double dx = p[0] - o[0], dy = p[1] - o[1], dz = p[2] - o[2];
+            const double e = -so * dx + co * dy;
+            const double n = -sl * co * dx - sl * so * dy + cl * dz;
+            const double u = cl * co * dx + cl * so * dy + sl * dz;
+            refE[i] = e * 1e-3;
+            refN[i] = n * 1e-3;
+            refR[i] = std::sqrt(e * e + n * n + u * u) * 1e-3;
+        }
+    };
+    std::vector<double> e(points), n(points), r(points);
+    double refSecs = 1e30, fastSecs = 1e30;
+    for (size_t rep = 0; rep < reps; ++rep) {
+        auto t0 = Clock::now();
+        reference();
+        refSecs = std::min(refSecs, secondsSince(t0));
+        t0 = Clock::now();
+        frame.toENU(points, lat.data(), lon.data(), alt.data(), e.data(), n.data(), r.data());
+        fastSecs = std::min(fastSecs, secondsSince(t0));
+    }
+    double posErr = 0.0, rangeErr = 0.0;
+    for (size_t i = 0; i < points; ++i) {
+        posErr = std::max(posErr, std::hypot(e[i] - refE[i], n[i] - refN[i]) * 1e3);
+        rangeErr = std::max(rangeErr, std::fabs(r[i] - refR[i]) * 1e3);
+    }
+    double trigErr = 0.0;
+    for (int i = -1000000; i <= 1000000; ++i) {
+        const double x = 3.14159265358979323846 * i / 1e6;
+        trigErr = std::max({ trigErr, std::fabs(fastSin(x) - std::sin(x)), std::fabs(fastCos(x) - std::cos(x)) });
+    }
+
+    std::cout << "bench geo: " << points << " points, best of " << reps << "\n";
+    std::cout << std::left << std::setw(10) << "KERNEL" << std::setw(14) << "MPOINTS/S" << "NS/POINT\n";
+    for (auto [name, secs] : { std::pair<const char*, double>{ "libm", refSecs }, { "batch", fastSecs } }) {
+        std::cout << std::left << std::setw(10) << name << std::fixed << std::setprecision(1)
+                  << std::setw(14) << points / secs / 1e6 << secs * 1e9 / points << "\n";
+    }
+    std::cout << std::scientific << std::setprecision(2) << "max error: sin/cos " << trigErr
+              << ", position " << posErr << " m, range " << rangeErr << " m\n";
+    return 0;
+}
+
+// -------------------- bench dem --------------------
+// Terrain lookups against synthetic 3" tiles written to a temporary
+// directory: a smooth analytic surface, so the interpolation error is
+// measurable. Batches of points scattered over the tiles, with a cache
+// that holds them all and one that keeps evicting.
+int benchDem(const std::map<std::string, std::string>& a) {
+    const size_t points = argSize(a, "points", 1000000);
+    const size_t batch = std::max<size_t>(1, argSize(a, "batch", 65536));
+    const int span = static_cast<int>(std::max<size_t>(1, argSize(a, "tiles", 3)));   // span x span tiles
+    constexpr size_t kSide = 1201;
+    auto surface = [](double lat, double lon) {
+        return 1000.0 + 800.0 * std::sin(lat * 7.0) * std::cos(lon * 5.0);
+    };
+
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / ("sentinel_dem_" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+    const int lat0 = 46, lon0 = 7;
+    std::vector<uint8_t> raw(2 * kSide * kSide);
+    for (int dy = 0; dy < span; ++dy) {
+        for (int dx = 0; dx < span; ++dx) {
+            for (size_t r = 0; r < kSide; ++r) {
+                for (size_t c = 0; c < kSide; ++c) {
+                    const double lat = lat0 + dy + 1.0 - static_cast<double>(r) / (kSide - 1);
+                    const double lon = lon0 + dx + static_cast<double>(c) / (kSide - 1);
+                    const auto v = static_cast<int16_t>(std::lround(surface(lat, lon)));
+                    raw[2 * (r * kSide + c)] = static_cast<uint8_t>(static_cast<uint16_t>(v) >> 8);
+                    raw[2 * (r * kSide + c) + 1] = static_cast<uint8_t>(v & 0xff);
+                }
+            }
+            char name[32];
+            std::snprintf(name, sizeof(name), "N%02dE%03d.hgt", lat0 + dy, lon0 + dx);
+            std::ofstream(dir / name, std::ios::binary).write(reinterpret_cast<const char*>(raw.data()),
+                                                              static_cast<std::streamsize>(raw.size()));
+        }
+    }
+
+    XorShift rng(73);
+    std::vector<double> lat(points), lon(points), elev(points);
+    for (size_t i = 0; i < points; ++i) {
+        lat[i] = lat0 + span * static_cast<double>(rng.next() % 1000000) / 1e6;
+        lon[i] = lon0 + span * static_cast<double>(rng.next() % 1000000) / 1e6;
+    }
+
+    std::cout << "bench dem: " << points << " points in batches of " << batch << " over "
+              << span * span << " tiles\n";
+    std::cout << std::left << std::setw(8) << "CACHE" << std::setw(12) << "COLD(ns)" << std::setw(12)
+              << "WARM(ns)" << std::setw(10) << "LOADS" << std::setw(12) << "EVICTIONS" << "MAX ERR(m)\n";
+    const size_t tiles = static_cast<size_t>(span * span);
+    for (size_t cache : { tiles, std::max<size_t>(1, tiles / 2) }) {
+        // The first pass maps the tiles and faults their pages in; later
+        // passes are the steady state of a running feed
+        ElevationModel dem(dir.string(), cache);
+        double cold = 0.0, warm = 1e30;
+        for (size_t rep = 0; rep < 4; ++rep) {
+            auto t0 = Clock::now();
+            for (size_t b = 0; b < points; b += batch) {
+                const size_t n = std::min(batch, points - b);
+                dem.lookup(n, lat.data() + b, lon.data() + b, elev.data() + b);
+            }
+            const double secs = secondsSince(t0);
+            if (rep == 0) cold = secs;
+            else warm = std::min(warm, secs);
+        }
+        double err = 0.0;
+        for (size_t i = 0; i < points; ++i) err = std::max(err, std::fabs(elev[i] - surface(lat[i], lon[i])));
+        std::cout << std::left << std::setw(8) << cache << std::fixed << std::setprecision(1)
+                  << std::setw(12) << cold * 1e9 / points << std::setw(12) << warm * 1e9 / points
+                  << std::setw(10) << dem.stats().tileLoads << std::setw(12) << dem.stats().evictions
+                  << err << "\n";
+    }
+    fs::remove_all(dir);
+    return 0;
+}
+
+void usage() {
+    std::cerr << "usage: sentinelscore bench ingest [--tracks N] [--updates N]"
+                 " [--threads 1,2,4,...] [--shard-bits B]\n"
+                 "       sentinelscore bench batch [--tracks N] [--updates N] [--batch N]\n"
+                 "       sentinelscore bench numa [--tracks N] [--k K] [--iters N]"
+                 " [--threads-per-node 1,2,4,...]\n"
+                 "       sentinelscore bench tlb [--tracks N] [--lookups N]\n"
+                 "       sentinelscore bench filter [--tracks N] [--cycles N]\n"
+                 "       sentinelscore bench assoc [--tracks N] [--plots N] [--scans N]\n"
+                 "       sentinelscore bench dedup [--tracks N,N,...] [--reps N]\n"
+                 "       sentinelscore bench group [--tracks N] [--reps N] [--threads 1,2,4,...]\n"
+                 "       sentinelscore bench geo [--points N] [--reps N]\n"
+                 "       sentinelscore bench dem [--points N] [--batch N] [--tiles SPAN]\n";
+}
+
+} // namespace
+
+int runBench(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+    const std::string name = argv[1];
+    auto args = parseArgs(argc, argv, 2);
+
+    if (name == "ingest") return benchIngest(args);
+    if (name == "batch") return benchBatch(args);
+    if (name == "numa") return benchNuma(args);
+    if (name == "tlb") return benchTlb(args);
+    if (name == "filter") return benchFilter(args);
+    if (name == "assoc") return benchAssoc(args);
+    if (name == "dedup") return benchDedup(args);
+    if (name == "group") return benchGroup(args);
+    if (name == "geo") return benchGeo(args);
+    if (name == "dem") return benchDem(args);
+
+    usage();
+    return 2;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+// -------------------- Benchmarks --------------------
+// Microbenchmarks for the data-path components, run as
+// "sentinelscore bench <name> [options]". argv[0] is "bench".
+int runBench(int argc, char** argv);
@@ -0,0 +1,69 @@
+#include "calibration.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+#include "csv.hpp"
+
+CalibrationTable CalibrationTable::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Failed to open calibration table: " + path);
+    }
+
+    CalibrationTable t;
+    std::string line;
+    size_t lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        auto cols = splitCSV(line);
+        if (t.byFeed_.empty() && cols.size() >= 2 && cols[1] == "range_scale") continue; // header
+        if (cols.size() < 4 || cols[0].empty() || !isNumeric(cols[1]) || !isNumeric(cols[2]) ||
+            !isNumeric(cols[3])) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNo) +
+                                     ": expected feed, range_scale, range_bias_km, rcs_bias_db");
+        }
+        const double scale = std::stod(cols[1]);
+        if (!(scale > 0.0)) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": range_scale must be positive");
+        }
+        if (!t.byFeed_.try_emplace(cols[0], scale, std::stod(cols[2]), std::stod(cols[3])).second) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": duplicate feed " + cols[0]);
+        }
+    }
+    return t;
+}
+
+const Calibration* CalibrationTable::find(const std::string& feedPath) const {
+    auto it = byFeed_.find(feedPath);
+    if (it == byFeed_.end()) {
+        const size_t slash = feedPath.find_last_of('/');
+        if (slash != std::string::npos) it = byFeed_.find(feedPath.substr(slash + 1));
+    }
+    return it == byFeed_.end() ? nullptr : &it->second;
+}
+
+const Calibration& CalibrationTable::forFeed(const std::string& feedPath) const {
+    const Calibration* c = find(feedPath);
+    return c ? *c : identity_;
+}
+
+bool CalibrationTable::correctsRange() const {
+    for (const auto& [feed, cal] : byFeed_) {
+        if (cal.correctsRange()) return true;
+    }
+    return false;
+}
+
+std::vector<std::string> CalibrationTable::unmatched(const std::vector<std::string>& feedPaths) const {
+    std::vector<std::string> out;
+    for (const auto& [feed, cal] : byFeed_) {
+        bool used = false;
+        for (const auto& p : feedPaths) used |= find(p) == &cal;
+        if (!used) out.push_back(feed);
+    }
+    return out;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "contact.hpp"
+
+// -------------------- Sensor Calibration --------------------
+// Known per-sensor biases, corrected as each row is parsed:
+//   range_km <- range_km * range_scale + range_bias_km
+//   rcs      <- rcs + rcs_bias_db (in dB), i.e. rcs_m2 * 10^(rcs_bias_db / 10)
+// The dB bias is turned into a factor once, so a row costs two multiplies
+// and an add.
+struct Calibration {
+    double range_scale = 1.0;
+    double range_bias_km = 0.0;
+    double rcs_bias_db = 0.0;
+    double rcs_factor = 1.0;    // 10^(rcs_bias_db / 10)
+
+    Calibration() = default;
+    Calibration(double scale, double bias_km, double rcs_db)
+        : range_scale(scale), range_bias_km(bias_km), rcs_bias_db(rcs_db),
+          rcs_factor(std::pow(10.0, rcs_db / 10.0)) {}
+
+    bool identity() const { return !correctsRange() && rcs_bias_db == 0.0; }
+    bool correctsRange() const { return range_scale != 1.0 || range_bias_km != 0.0; }
+
+    void apply(Contact& c) const {
+        c.range_km = c.range_km * range_scale + range_bias_km;
+        c.rcs_m2 *= rcs_factor;
+    }
+};
+
+// CSV columns (header optional): feed, range_scale, range_bias_km, rcs_bias_db
+// A feed is matched by its path as given on the command line, or else by
+// its file name.
+class CalibrationTable {
+public:
+    static CalibrationTable load(const std::string& path);
+
+    // The feed's entry; identity when it has none
+    const Calibration& forFeed(const std::string& feedPath) const;
+
+    // Entries that match none of the given feeds (likely typos)
+    std::vector<std::string> unmatched(const std::vector<std::string>& feedPaths) const;
+
+    size_t size() const { return byFeed_.size(); }
+
+    // True if any entry corrects range. With an origin the range of a
+    // positioned update is recomputed from its position, which drops it.
+    bool correctsRange() const;
+
+private:
+    const Calibration* find(const std::string& feedPath) const;
+
+    std::unordered_map<std::string, Calibration> byFeed_;
+    Calibration identity_;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// -------------------- Shared Helpers --------------------
+// Hashed spatial grid: a local-frame coordinate's cell, and a cell's bucket
+// among 2^bits. Cells far apart may share a bucket, so lookups still
+// compare positions.
+inline int64_t cellOf(double km, double cell) { return static_cast<int64_t>(std::floor(km / cell)); }
+
+inline uint32_t bucketOf(int64_t cx, int64_t cy, unsigned bits) {
+    const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) |
+                         static_cast<uint32_t>(cy);
+    return static_cast<uint32_t>((key * 0x9e3779b97f4a7c15ull) >> (64 - bits));
+}
+
+// fn(worker) on n threads, the caller being one of them. The first
+// exception a worker throws is rethrown here once all have finished.
+template <class Fn>
+void parallel(size_t n, Fn fn) {
+    std::exception_ptr error;
+    std::mutex mu;
+    auto run = [&](size_t t) {
+        try {
+            fn(t);
+        } catch (...) {
+            std::lock_guard<std::mutex> lk(mu);
+            if (!error) error = std::current_exception();
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < n; ++t) pool.emplace_back(run, t);
+    run(0);
+    for (auto& t : pool) t.join();
+    if (error) std::rethrow_exception(error);
+}
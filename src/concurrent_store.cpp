@@ -0,0 +1,143 @@
+#include "concurrent_store.hpp"
+
+#include <algorithm>
+
+namespace {
+
+constexpr size_t kInitialSlots = 64;    // per shard, power of two
+constexpr size_t kReclaimBatch = 64;    // retired records per reclaim attempt
+constexpr size_t kMaxFreeRecords = 1024;
+
+} // namespace
+
+ConcurrentTrackStore::ConcurrentTrackStore(unsigned shardBits)
+    : shardShift_(64 - std::clamp(shardBits, 1u, 16u)),
+      shards_(size_t{1} << (64 - shardShift_)) {
+    for (auto& s : shards_) s.table.store(new Table(kInitialSlots), std::memory_order_relaxed);
+}
+
+ConcurrentTrackStore::~ConcurrentTrackStore() {
+    for (auto& s : shards_) {
+        Table* t = s.table.load(std::memory_order_relaxed);
+        for (size_t i = 0; i <= t->mask; ++i) delete t->slots[i].rec.load(std::memory_order_relaxed);
+        delete t;
+        for (auto& r : s.retired) delete r.second;
+        for (auto& o : s.oldTables) delete o.second;
+        for (Record* r : s.free) delete r;
+    }
+}
+
+TrackKey ConcurrentTrackStore::intern(std::string_view id) {
+    // FNV-1a, then a splitmix finalizer so the top bits (shard) and low bits
+    // (slot) are both well mixed
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char ch : id) { h ^= ch; h *= 1099511628211ull; }
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27; h *= 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    return { h ? h : 1, id };   // 0 marks an empty slot
+}
+
+void ConcurrentTrackStore::upsert(const TrackKey& key, const Contact& c, double t) {
+    Shard& s = shardFor(key.hash);
+    std::lock_guard<std::mutex> lk(s.mu);
+
+    Record* rec;
+    if (!s.free.empty()) {
+        rec = s.free.back();
+        s.free.pop_back();
+    } else {
+        rec = new Record();
+    }
+    rec->c = c;
+    rec->last_seen = t;
+    rec->hash = key.hash;
+
+    Table* tbl = s.table.load(std::memory_order_relaxed);
+    for (size_t i = key.hash & tbl->mask;; i = (i + 1) & tbl->mask) {
+        Slot& slot = tbl->slots[i];
+        uint64_t h = slot.hash.load(std::memory_order_relaxed);
+        if (h == 0) {
+            slot.rec.store(rec, std::memory_order_release);
+            slot.hash.store(key.hash, std::memory_order_release);
+            if (++s.count * 2 > tbl->mask + 1) grow(s);
+            return;
+        }
+        if (h == key.hash) {
+            const Record* cur = slot.rec.load(std::memory_order_relaxed);
+            if (cur->c.id != key.id) continue;   // hash collision
+            Record* old = slot.rec.exchange(rec, std::memory_order_seq_cst);
+            s.retired.emplace_back(epochs_.tag(), old);
+            if (s.retired.size() >= kReclaimBatch) reclaim(s);
+            return;
+        }
+    }
+}
+
+void ConcurrentTrackStore::grow(Shard& s) {
+    Table* old = s.table.load(std::memory_order_relaxed);
+    auto* next = new Table((old->mask + 1) * 2);
+    for (size_t i = 0; i <= old->mask; ++i) {
+        uint64_t h = old->slots[i].hash.load(std::memory_order_relaxed);
+        if (h == 0) continue;
+        size_t j = h & next->mask;
+        while (next->slots[j].hash.load(std::memory_order_relaxed) != 0) j = (j + 1) & next->mask;
+        next->slots[j].rec.store(old->slots[i].rec.load(std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+        next->slots[j].hash.store(h, std::memory_order_relaxed);
+    }
+    // Readers still walking the old table see valid (possibly stale)
+    // records until the table itself is reclaimed
+    s.table.store(next, std::memory_order_seq_cst);
+    s.oldTables.emplace_back(epochs_.tag(), old);
+}
+
+void ConcurrentTrackStore::reclaim(Shard& s) {
+    epochs_.advance();
+    const uint64_t safe = epochs_.safeEpoch();
+
+    auto split = std::partition(s.retired.begin(), s.retired.end(),
+                                [safe](const auto& r){ return r.first >= safe; });
+    for (auto it = split; it != s.retired.end(); ++it) {
+        if (s.free.size() < kMaxFreeRecords) s.free.push_back(it->second);
+        else delete it->second;
+    }
+    s.retired.erase(split, s.retired.end());
+
+    auto tsplit = std::partition(s.oldTables.begin(), s.oldTables.end(),
+                                 [safe](const auto& t){ return t.first >= safe; });
+    for (auto it = tsplit; it != s.oldTables.end(); ++it) delete it->second;
+    s.oldTables.erase(tsplit, s.oldTables.end());
+}
+
+bool ConcurrentTrackStore::find(const TrackKey& key, Record& out) const {
+    auto guard = epochs_.pin();
+    const Table* tbl = shardFor(key.hash).table.load(std::memory_order_seq_cst);
+    for (size_t i = key.hash & tbl->mask;; i = (i + 1) & tbl->mask) {
+        const Slot& slot = tbl->slots[i];
+        uint64_t h = slot.hash.load(std::memory_order_acquire);
+        if (h == 0) return false;
+        if (h != key.hash) continue;
+        const Record* rec = slot.rec.load(std::memory_order_acquire);
+        if (rec->c.id != key.id) continue;
+        out = *rec;
+        return true;
+    }
+}
+
+void ConcurrentTrackStore::forEach(const std::function<void(const Record&)>& fn) const {
+    auto guard = epochs_.pin();
+    for (const auto& s : shards_) {
+        const Table* tbl = s.table.load(std::memory_order_seq_cst);
+        for (size_t i = 0; i <= tbl->mask; ++i) {
+            if (tbl->slots[i].hash.load(std::memory_order_acquire) == 0) continue;
+            fn(*tbl->slots[i].rec.load(std::memory_order_acquire));
+        }
+    }
+}
+
+size_t ConcurrentTrackStore::size() const {
+    size_t n = 0;
+    for (const auto& s : shards_) n += s.count.load(std::memory_order_relaxed);
+    return n;
+}
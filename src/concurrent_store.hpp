@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "contact.hpp"
+#include "epoch.hpp"
+
+// -------------------- Concurrent Track Store --------------------
+// Track table for many ingest threads updating at once. Ids are interned
+// once to a 64-bit key (hash + the id itself); the key picks one of 2^k
+// shards and a slot in that shard's open-addressing table.
+//
+// - Upserts lock only their shard, so feeds touching different tracks
+//   rarely meet.
+// - Lookups and scans take no locks: each slot holds an atomic pointer to
+//   an immutable record, and an upsert publishes a fresh record rather than
+//   writing in place.
+// - Replaced records and outgrown tables are reclaimed through an epoch
+//   domain. Each shard keeps its own retire list and recycles reclaimed
+//   records, so steady-state upserts neither allocate nor touch a global
+//   lock.
+//
+// serve does not use it. It merges its feeds into one stream-time order
+// and applies each cycle as a batch on the cycle thread. That thread is the
+// only writer by design: association, smoothing, windows and snapshots all
+// read the picture between batches, and the batched TrackStore write (see
+// applyBatch) is faster than per-update upserts here. This table is for
+// ingest front ends that apply feeds in arrival order on threads of their
+// own, with readers scanning it concurrently.
+struct TrackKey {
+    uint64_t hash;
+    std::string_view id;   // must outlive the call that uses the key
+};
+
+class ConcurrentTrackStore {
+public:
+    struct Record {
+        Contact c;
+        double last_seen;
+        uint64_t hash;
+    };
+
+    // 2^shardBits shards (clamped to 1..16 bits)
+    explicit ConcurrentTrackStore(unsigned shardBits = 6);
+    ~ConcurrentTrackStore();
+
+    ConcurrentTrackStore(const ConcurrentTrackStore&) = delete;
+    ConcurrentTrackStore& operator=(const ConcurrentTrackStore&) = delete;
+
+    static TrackKey intern(std::string_view id);
+
+    // Safe from any number of threads.
+    void upsert(const TrackKey& key, const Contact& c, double t);
+    void upsert(const Contact& c, double t) { upsert(intern(c.id), c, t); }
+
+    // Lock-free lookup; copies the record out under an epoch pin.
+    bool find(const TrackKey& key, Record& out) const;
+
+    // Lock-free scan of every record under one pin. Concurrent upserts may
+    // or may not be visible; each record seen is internally consistent.
+    void forEach(const std::function<void(const Record&)>& fn) const;
+
+    size_t size() const;
+    size_t shards() const { return shards_.size(); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> hash{0};            // 0 = empty
+        std::atomic<Record*> rec{nullptr};
+    };
+
+    struct Table {
+        explicit Table(size_t cap) : mask(cap - 1), slots(new Slot[cap]) {}
+        size_t mask;
+        std::unique_ptr<Slot[]> slots;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mu;
+        std::atomic<Table*> table{nullptr};
+        std::atomic<size_t> count{0};                        // written under mu
+        std::vector<std::pair<uint64_t, Record*>> retired;   // (epoch tag, record)
+        std::vector<std::pair<uint64_t, Table*>> oldTables;
+        std::vector<Record*> free;                           // reclaimed, reusable
+    };
+
+    Shard& shardFor(uint64_t hash) { return shards_[hash >> shardShift_]; }
+    const Shard& shardFor(uint64_t hash) const { return shards_[hash >> shardShift_]; }
+    void grow(Shard& s);
+    void reclaim(Shard& s);
+
+    unsigned shardShift_;
+    std::vector<Shard> shards_;
+    mutable EpochDomain epochs_;
+};
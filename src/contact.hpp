@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// -------------------- Domain Model --------------------
+// Standard identities (APP-6). The first three keep their values, which are
+// stored in archives. Joker and Faker are exercise tracks playing suspect
+// and hostile.
+enum class IFF : uint8_t { Friend, Foe, Unknown, Pending, AssumedFriend, Neutral, Suspect, Joker, Faker };
+constexpr size_t kIffs = 9;
+
+// Which side an identity puts a track on. Tracks on different determined
+// sides are never one aircraft.
+enum class IffSide : uint8_t { Undetermined, Friendly, Neutral, Hostile };
+
+inline IffSide iffSide(IFF iff) {
+    static constexpr IffSide kSide[kIffs] = {
+        IffSide::Friendly, IffSide::Hostile, IffSide::Undetermined, IffSide::Undetermined,
+        IffSide::Friendly, IffSide::Neutral, IffSide::Hostile, IffSide::Hostile, IffSide::Hostile,
+    };
+    return kSide[static_cast<size_t>(iff)];
+}
+
+// Neither undetermined nor on different sides
+inline bool iffCompatible(IFF a, IFF b) {
+    const IffSide sa = iffSide(a), sb = iffSide(b);
+    return sa == IffSide::Undetermined || sb == IffSide::Undetermined || sa == sb;
+}
+
+// Platform class, when a feed reports one. Classes are small dense codes, so
+// per-class weights and thresholds are plain tables indexed by them: a new
+// class is one more enumerator, name and table entry, not a new branch.
+enum class Platform : uint8_t { Unclassified, Fighter, Bomber, Uav, Missile, Helicopter, Airliner };
+constexpr size_t kPlatforms = 7;
+
+struct Contact {
+    std::string id;           // Track ID or callsign
+    IFF iff;                  // Identity (Friend/Foe/Unknown/...)
+    double range_km;          // Slant range (km)
+    double closing_mps;       // Positive means approaching (m/s)
+    double altitude_m;        // Altitude (m)
+    double rcs_m2;            // Radar cross-section (m^2)
+    bool has_closing = true;  // False when the feed left closing_mps empty
+    bool has_pos = false;     // True when east/north were reported
+    double east_km = 0.0;     // Local frame position (km, east of origin)
+    double north_km = 0.0;    // Local frame position (km, north of origin)
+    double terrain_m = 0.0;   // Ground elevation below the contact (m), 0 without a DEM
+    bool has_geo = false;     // True when read as latitude/longitude (feeds with an origin)
+    double lat_deg = 0.0;     // Geodetic position as reported; LocalFrame::convert
+    double lon_deg = 0.0;     // turns it into east/north
+    Platform platform = Platform::Unclassified;
+};
+
+// -------------------- Utilities --------------------
+inline std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return "";
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+// Accepted spellings, matched case-insensitively: names and APP-6 letters
+namespace iff_codes {
+
+struct Code {
+    std::string_view name;   // upper case
+    IFF iff;
+};
+
+constexpr Code kCodes[] = {
+    { "FRIEND", IFF::Friend },   { "F", IFF::Friend },
+    { "FOE", IFF::Foe },         { "HOSTILE", IFF::Foe },   { "H", IFF::Foe },
+    { "UNKNOWN", IFF::Unknown }, { "U", IFF::Unknown },
+    { "PENDING", IFF::Pending }, { "P", IFF::Pending },
+    { "ASSUMED_FRIEND", IFF::AssumedFriend }, { "ASSUMED FRIEND", IFF::AssumedFriend },
+    { "A", IFF::AssumedFriend },
+    { "NEUTRAL", IFF::Neutral }, { "N", IFF::Neutral },
+    { "SUSPECT", IFF::Suspect }, { "S", IFF::Suspect },
+    { "JOKER", IFF::Joker },     { "J", IFF::Joker },
+    { "FAKER", IFF::Faker },     { "K", IFF::Faker },
+};
+
+constexpr char upper(char c) { return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c; }
+
+// Perfect hash of the spellings above: first, last and middle character
+// plus length. Adding a spelling may need new multipliers; the
+// static_assert below says so.
+constexpr size_t kSlots = 32;
+constexpr size_t hash(std::string_view t) {
+    return (static_cast<size_t>(upper(t.front())) + 26 * static_cast<size_t>(upper(t.back())) +
+            11 * static_cast<size_t>(upper(t[t.size() / 2])) + t.size()) % kSlots;
+}
+
+constexpr int kEmpty = -1;
+constexpr std::array<int, kSlots> buildTable() {
+    std::array<int, kSlots> table {};
+    for (auto& slot : table) slot = kEmpty;
+    for (size_t i = 0; i < sizeof(kCodes) / sizeof(kCodes[0]); ++i) table[hash(kCodes[i].name)] = static_cast<int>(i);
+    return table;
+}
+constexpr std::array<int, kSlots> kTable = buildTable();
+
+constexpr bool collisionFree() {
+    for (size_t i = 0; i < sizeof(kCodes) / sizeof(kCodes[0]); ++i) {
+        if (kTable[hash(kCodes[i].name)] != static_cast<int>(i)) return false;
+    }
+    return true;
+}
+static_assert(collisionFree(), "IFF spellings collide in the perfect hash");
+
+} // namespace iff_codes
+
+// One hash, one table load and one case-folding compare; no allocation
+inline std::optional<IFF> parseIFF(std::string_view token) {
+    using namespace iff_codes;
+    if (token.empty()) return std::nullopt;
+    const int slot = kTable[hash(token)];
+    if (slot == kEmpty) return std::nullopt;
+    const Code& code = kCodes[slot];
+    if (code.name.size() != token.size()) return std::nullopt;
+    for (size_t i = 0; i < token.size(); ++i) {
+        if (upper(token[i]) != code.name[i]) return std::nullopt;
+    }
+    return code.iff;
+}
+
+inline const char* iffToStr(IFF iff) {
+    static constexpr const char* kNames[kIffs] = {
+        "FRIEND", "FOE", "UNKNOWN", "PENDING", "ASSUMED_FRIEND", "NEUTRAL", "SUSPECT", "JOKER", "FAKER",
+    };
+    return kNames[static_cast<size_t>(iff)];
+}
+
+namespace platform_codes {
+
+struct Code {
+    std::string_view name;   // upper case
+    Platform platform;
+};
+
+constexpr Code kCodes[] = {
+    { "UNCLASSIFIED", Platform::Unclassified },
+    { "FIGHTER", Platform::Fighter },
+    { "BOMBER", Platform::Bomber },
+    { "UAV", Platform::Uav },         { "UAS", Platform::Uav },   { "DRONE", Platform::Uav },
+    { "MISSILE", Platform::Missile },
+    { "HELICOPTER", Platform::Helicopter }, { "HELO", Platform::Helicopter },
+    { "AIRLINER", Platform::Airliner },
+};
+
+} // namespace platform_codes
+
+// Class name (case-insensitive) to its code. The list is short, so a scan
+// costs about what a hash would; it runs once per row at ingest.
+inline std::optional<Platform> parsePlatform(std::string_view token) {
+    for (const auto& code : platform_codes::kCodes) {
+        if (code.name.size() != token.size()) continue;
+        size_t i = 0;
+        while (i < token.size() && iff_codes::upper(token[i]) == code.name[i]) ++i;
+        if (i == token.size()) return code.platform;
+    }
+    return std::nullopt;
+}
+
+inline const char* platformToStr(Platform p) {
+    static constexpr const char* kNames[kPlatforms] = {
+        "UNCLASSIFIED", "FIGHTER", "BOMBER", "UAV", "MISSILE", "HELICOPTER", "AIRLINER",
+    };
+    return kNames[static_cast<size_t>(p)];
+}
+
+// True if the whole token parses as a number
+inline bool isNumeric(const std::string& s) {
+    if (s.empty()) return false;
+    char* end = nullptr;
+    std::strtod(s.c_str(), &end);
+    return end == s.c_str() + s.size();
+}
+
+// Safe stod with default
+inline double toDouble(const std::string& s, double def = 0.0) {
+    try { return std::stod(s); }
+    catch (...) { return def; }
+}
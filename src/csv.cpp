@@ -0,0 +1,91 @@
+#include "csv.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+std::vector<std::string> splitCSV(const std::string& line) {
+    std::stringstream ss(line);
+    std::string tok;
+    std::vector<std::string> cols;
+    while (std::getline(ss, tok, ',')) cols.push_back(trim(tok));
+    return cols;
+}
+
+std::optional<Contact> parseContact(const std::vector<std::string>& cols, size_t first,
+                                    const std::string& line) {
+    if (cols.size() < first + 6) {
+        std::cerr << "Skipping malformed row: " << line << "\n";
+        return std::nullopt;
+    }
+
+    auto iff = parseIFF(cols[first + 1]);
+    if (!iff) {
+        std::cerr << "Skipping row with invalid IFF: " << line << "\n";
+        return std::nullopt;
+    }
+
+    Contact c {
+        cols[first],
+        *iff,
+        toDouble(cols[first + 2], 1e9),   // range
+        toDouble(cols[first + 3], 0.0),   // closing speed
+        toDouble(cols[first + 4], 0.0),   // altitude
+        toDouble(cols[first + 5], 1.0)    // rcs
+    };
+    // Some feeds report range only; continuous mode can estimate the rate
+    c.has_closing = !cols[first + 3].empty();
+
+    // Optional local-frame position, needed for per-asset scoring
+    if (cols.size() >= first + 8 && !cols[first + 6].empty() && !cols[first + 7].empty()) {
+        c.has_pos  = true;
+        c.east_km  = toDouble(cols[first + 6], 0.0);
+        c.north_km = toDouble(cols[first + 7], 0.0);
+    }
+
+    // Optional platform class; a name we do not know scores as unclassified
+    // rather than dropping the row
+    if (cols.size() >= first + 9 && !cols[first + 8].empty()) {
+        if (auto p = parsePlatform(cols[first + 8])) {
+            c.platform = *p;
+        } else {
+            std::cerr << "Unknown platform class, scoring as unclassified: " << line << "\n";
+        }
+    }
+    return c;
+}
+
+std::vector<Contact> loadCSV(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Failed to open CSV: " + path);
+    }
+
+    std::vector<Contact> out;
+    std::string line;
+    bool maybeHeader = true;
+
+    while (std::getline(in, line)) {
+        line = trim(line);
+        if (line.empty()) continue;
+        if (line[0] == '#') continue; // comment
+
+        std::vector<std::string> cols = splitCSV(line);
+
+        if (maybeHeader) {
+            // Detect header if non-numeric where numeric expected and skip it
+            if (cols.size() >= 6) {
+                auto iffParsed = parseIFF(cols[1]);
+                bool looksHeader =
+                    !iffParsed.has_value() || cols[2] == "range_km" || cols[3] == "closing_mps";
+                if (looksHeader) { maybeHeader = false; continue; }
+            }
+            maybeHeader = false;
+        }
+
+        if (auto c = parseContact(cols, 0, line)) out.push_back(*c);
+    }
+
+    return out;
+}
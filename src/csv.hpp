@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "contact.hpp"
+
+// -------------------- CSV Ingest --------------------
+// Split one CSV line into trimmed columns.
+std::vector<std::string> splitCSV(const std::string& line);
+
+// Parse the contact columns starting at cols[first]:
+// id, iff, range_km, closing_mps, altitude_m, rcs_m2[, east_km, north_km[, platform]]
+// An empty closing_mps reads as 0 with has_closing unset. Logs and returns
+// nullopt for malformed rows.
+std::optional<Contact> parseContact(const std::vector<std::string>& cols, size_t first,
+                                    const std::string& line);
+
+// CSV columns (header optional):
+// id, iff (a name or APP-6 letter, see parseIFF), range_km, closing_mps, altitude_m, rcs_m2[, east_km, north_km[, platform]]
+// platform is a class name (see parsePlatform); east/north may be left empty.
+std::vector<Contact> loadCSV(const std::string& path);
@@ -0,0 +1,139 @@
+#include "dedup.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr size_t kDims = 4;   // east, north, altitude, closing
+
+uint32_t bucketOf(const int64_t (&cell)[kDims], unsigned bits) {
+    uint64_t h = 0;
+    for (int64_t c : cell) h = (h ^ static_cast<uint64_t>(c)) * 0x9e3779b97f4a7c15ull;
+    return static_cast<uint32_t>(h >> (64 - bits));
+}
+
+} // namespace
+
+TrackDeduplicator::TrackDeduplicator(DedupParams p) : p_(p) {}
+
+TrackHandle TrackDeduplicator::find(TrackHandle h) {
+    while (parent_[h] != h) {
+        parent_[h] = parent_[parent_[h]];   // path halving
+        h = parent_[h];
+    }
+    return h;
+}
+
+void TrackDeduplicator::run(const TrackStore& store, double t) {
+    const size_t n = store.size();
+    const double cellSize[kDims] = { 2.0 * p_.pos_km, 2.0 * p_.pos_km, 2.0 * p_.alt_m,
+                                     2.0 * p_.closing_mps };
+    const double tol[kDims] = { p_.pos_km, p_.pos_km, p_.alt_m, p_.closing_mps };
+    auto coords = [&](TrackHandle h, double (&x)[kDims]) {
+        x[0] = store.east_km[h];
+        x[1] = store.north_km[h];
+        x[2] = store.altitude_m[h];
+        x[3] = store.closing_mps[h];
+    };
+    auto eligible = [&](TrackHandle h) {
+        return store.has_pos[h] && t - store.last_seen[h] <= p_.maxAge_s;
+    };
+
+    // Sixteen probes per track into a table of 8 buckets per track: most
+    // probes find the bucket empty in the occupancy bitmap, which stays in
+    // cache, and so touch neither the bucket table nor an entry
+    unsigned bits = 4;
+    while ((size_t{1} << bits) < 8 * n) ++bits;
+
+    // Bucket the eligible tracks by their own cell
+    keyed_.clear();
+    Entry e;
+    int64_t cell[kDims];
+    for (TrackHandle h = 0; h < n; ++h) {
+        if (!eligible(h)) continue;
+        coords(h, e.x);
+        for (size_t d = 0; d < kDims; ++d) cell[d] = static_cast<int64_t>(std::floor(e.x[d] / cellSize[d]));
+        keyed_.push_back((static_cast<uint64_t>(bucketOf(cell, bits)) << 32) | h);
+    }
+    const size_t buckets = size_t{1} << bits;
+    start_.assign(buckets + 1, 0);
+    for (uint64_t k : keyed_) ++start_[(k >> 32) + 1];
+    for (size_t b = 1; b <= buckets; ++b) start_[b] += start_[b - 1];
+    occupied_.assign((buckets + 63) / 64, 0);
+    for (uint64_t k : keyed_) occupied_[(k >> 32) >> 6] |= uint64_t{1} << ((k >> 32) & 63);
+    entries_.resize(keyed_.size());
+    std::vector<uint32_t> fill(start_.begin(), start_.end() - 1);
+    for (uint64_t k : keyed_) {
+        Entry& en = entries_[fill[k >> 32]++];
+        en.h = static_cast<TrackHandle>(k);
+        coords(en.h, en.x);
+    }
+
+    parent_.resize(n);
+    groupSide_.resize(n);
+    for (TrackHandle h = 0; h < n; ++h) {
+        parent_[h] = h;
+        groupSide_[h] = iffSide(store.iff[h]);
+    }
+
+    // Probe the 2^4 cells a tolerance box can reach, sweeping in bucket
+    // order so the track's own bucket is at hand. Each pair is seen from
+    // both ends; only the lower handle joins it.
+    int64_t near[kDims][2];
+    for (const Entry& a : entries_) {
+        for (size_t d = 0; d < kDims; ++d) {
+            const double f = a.x[d] / cellSize[d];
+            const int64_t c = static_cast<int64_t>(std::floor(f));
+            near[d][0] = c;
+            near[d][1] = f - static_cast<double>(c) < 0.5 ? c - 1 : c + 1;
+        }
+        for (unsigned mask = 0; mask < (1u << kDims); ++mask) {
+            for (size_t d = 0; d < kDims; ++d) cell[d] = near[d][(mask >> d) & 1];
+            const uint32_t b = bucketOf(cell, bits);
+            if (!((occupied_[b >> 6] >> (b & 63)) & 1)) continue;
+            for (uint32_t i = start_[b]; i < start_[b + 1]; ++i) {
+                const Entry& o = entries_[i];
+                if (o.h <= a.h) continue;
+                bool close = true;
+                for (size_t d = 0; d < kDims; ++d) close &= std::fabs(a.x[d] - o.x[d]) <= tol[d];
+                if (!close) continue;
+                // The check is on whole groups: an unknown track close to a
+                // friend and a foe must not chain them together
+                const TrackHandle ra = find(a.h), ro = find(o.h);
+                const IffSide sa = groupSide_[ra], so = groupSide_[ro];
+                if (ra == ro || (sa != IffSide::Undetermined && so != IffSide::Undetermined && sa != so)) continue;
+                const TrackHandle root = std::min(ra, ro);
+                parent_[std::max(ra, ro)] = root;
+                groupSide_[root] = sa != IffSide::Undetermined ? sa : so;
+            }
+        }
+    }
+
+    // Highest score in each group represents it (ties to the lower handle)
+    std::vector<TrackHandle> best(n);
+    std::vector<uint32_t> size(n, 0);
+    for (TrackHandle h = 0; h < n; ++h) best[h] = h;
+    for (TrackHandle h = 0; h < n; ++h) {
+        const TrackHandle r = find(h);
+        ++size[r];
+        const TrackHandle b = best[r];
+        if (store.score[h] > store.score[b] || (store.score[h] == store.score[b] && h < b)) best[r] = h;
+    }
+    rep_.resize(n);
+    duplicates_ = groups_ = 0;
+    for (TrackHandle h = 0; h < n; ++h) {
+        const TrackHandle r = find(h);
+        rep_[h] = best[r];
+        if (h == r && size[r] > 1) {
+            ++groups_;
+            duplicates_ += size[r] - 1;
+        }
+    }
+}
+
+void TrackDeduplicator::filter(Ranking& ranking) const {
+    ranking.erase(std::remove_if(ranking.begin(), ranking.end(),
+                                 [this](TrackHandle h) { return representative(h) != h; }),
+                  ranking.end());
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "track_store.hpp"
+
+// -------------------- Cross-Id Deduplication --------------------
+// Different sensors can report one aircraft under different ids. Two tracks
+// are duplicates when their east, north, altitude and closing speed all lie
+// within the tolerances. Tracks are bucketed in a 4-D spatial hash whose
+// cells are twice the tolerances, so a duplicate sits in the track's own
+// cell or the neighbour on the nearer side in each dimension: 16 probes per
+// track, linear in the picture. Duplicate pairs are joined with union-find,
+// so chains merge, but never across IFF sides (a suspect can merge with a
+// foe, never with a friend or a neutral). Each group is represented by its
+// highest-scoring member.
+struct DedupParams {
+    double pos_km = 1.0;         // east and north
+    double alt_m = 300.0;
+    double closing_mps = 50.0;
+    double maxAge_s = 30.0;      // older tracks are neither merged nor merged into
+};
+
+class TrackDeduplicator {
+public:
+    explicit TrackDeduplicator(DedupParams p = {});
+
+    // Group the picture at time t; afterwards representative(h) is the
+    // member standing in for h's group (h itself if it has no duplicate).
+    void run(const TrackStore& store, double t);
+
+    // Drop every track that is not its group's representative, keeping order.
+    void filter(Ranking& ranking) const;
+
+    TrackHandle representative(TrackHandle h) const {
+        return h < rep_.size() ? rep_[h] : h;
+    }
+    size_t duplicates() const { return duplicates_; }   // tracks hidden by the last run
+    size_t groups() const { return groups_; }           // groups with more than one member
+
+private:
+    TrackHandle find(TrackHandle h);
+
+    DedupParams p_;
+    std::vector<TrackHandle> parent_;      // union-find forest, then representatives
+    std::vector<TrackHandle> rep_;
+    std::vector<IffSide> groupSide_;       // by root: the side its known IFFs put it on
+    // Probed entries are read at random, so each track's coordinates sit
+    // in one record instead of four columns
+    struct Entry {
+        double x[4];                       // east, north, altitude, closing
+        TrackHandle h;
+    };
+
+    std::vector<uint32_t> start_;          // hash buckets, counting-sorted
+    std::vector<uint64_t> occupied_;       // bit per non-empty bucket
+    std::vector<uint64_t> keyed_;          // bucket << 32 | handle, unsorted
+    std::vector<Entry> entries_;           // in bucket order
+    size_t duplicates_ = 0;
+    size_t groups_ = 0;
+};
@@ -0,0 +1,73 @@
+#include "epoch.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+EpochDomain::~EpochDomain() {
+    for (auto& r : retired_) r.deleter();
+}
+
+EpochDomain::Guard EpochDomain::pin() {
+    // Start where this thread last found a free slot, so concurrent readers
+    // don't all fight over slot 0
+    thread_local size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    for (;;) {
+        for (size_t i = 0; i < kMaxReaders; ++i) {
+            const size_t idx = (hint + i) % kMaxReaders;
+            auto& s = slots_[idx];
+            uint64_t idle = kIdle;
+            uint64_t e = global_.load(std::memory_order_seq_cst);
+            if (!s.epoch.compare_exchange_strong(idle, e, std::memory_order_seq_cst)) continue;
+            // If a writer advanced the epoch between our read and the
+            // announcement it may already have scanned past this slot;
+            // re-announce with the new epoch.
+            for (uint64_t now; (now = global_.load(std::memory_order_seq_cst)) != e; e = now) {
+                s.epoch.store(now, std::memory_order_seq_cst);
+            }
+            hint = idx;
+            return Guard(&s.epoch);
+        }
+        std::this_thread::yield();
+    }
+}
+
+uint64_t EpochDomain::minPinned() const {
+    uint64_t m = std::numeric_limits<uint64_t>::max();
+    for (const auto& s : slots_) {
+        uint64_t e = s.epoch.load(std::memory_order_seq_cst);
+        if (e != kIdle) m = std::min(m, e);
+    }
+    return m;
+}
+
+void EpochDomain::retire(std::function<void()> deleter) {
+    // The object was unlinked before this point, so any reader that pins
+    // after the increment cannot reach it.
+    uint64_t e = global_.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lk(retiredMu_);
+        retired_.push_back({e, std::move(deleter)});
+    }
+    reclaim();
+}
+
+size_t EpochDomain::reclaim() {
+    std::vector<Retired> ready;
+    {
+        std::lock_guard<std::mutex> lk(retiredMu_);
+        const uint64_t safe = minPinned();
+        auto split = std::partition(retired_.begin(), retired_.end(),
+                                    [safe](const Retired& r){ return r.epoch >= safe; });
+        ready.assign(std::make_move_iterator(split), std::make_move_iterator(retired_.end()));
+        retired_.erase(split, retired_.end());
+    }
+    // Deleters run outside the lock
+    for (auto& r : ready) r.deleter();
+    return ready.size();
+}
+
+size_t EpochDomain::pending() const {
+    std::lock_guard<std::mutex> lk(retiredMu_);
+    return retired_.size();
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// -------------------- Epoch-Based Reclamation --------------------
+// Readers pin the current epoch for the duration of a read-side section
+// (no locks, no allocation). Writers unlink an object, then retire() it;
+// the deleter runs once every reader that could still hold a reference has
+// unpinned. Only the writer side (retire/reclaim) takes a mutex.
+class EpochDomain {
+public:
+    static constexpr size_t kMaxReaders = 128;   // concurrent pins
+
+    EpochDomain() = default;
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+    ~EpochDomain();   // runs all outstanding deleters
+
+    class Guard {
+    public:
+        Guard(Guard&& o) noexcept : slot_(o.slot_) { o.slot_ = nullptr; }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard() { if (slot_) slot_->store(kIdle, std::memory_order_release); }
+
+    private:
+        friend class EpochDomain;
+        explicit Guard(std::atomic<uint64_t>* slot) : slot_(slot) {}
+        std::atomic<uint64_t>* slot_;
+    };
+
+    // Enter a read-side section. Lock-free; spins only if every slot is taken.
+    Guard pin();
+
+    // Hand over an object that readers can no longer reach. Advances the epoch
+    // and opportunistically reclaims.
+    void retire(std::function<void()> deleter);
+
+    // Run deleters whose epoch no pinned reader can still observe.
+    // Returns the number reclaimed.
+    size_t reclaim();
+
+    size_t pending() const;
+
+    // Building blocks for callers that keep their own retire lists (e.g.
+    // per shard, to avoid the shared mutex). Tag an unlinked object with
+    // tag(); it may be freed once safeEpoch() > tag. advance() moves the
+    // epoch on so that eventually becomes true.
+    uint64_t tag() const { return global_.load(std::memory_order_seq_cst); }
+    void advance() { global_.fetch_add(1, std::memory_order_seq_cst); }
+    uint64_t safeEpoch() const { return minPinned(); }
+
+private:
+    static constexpr uint64_t kIdle = 0;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{kIdle};
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        std::function<void()> deleter;
+    };
+
+    uint64_t minPinned() const;
+
+    std::atomic<uint64_t> global_{1};
+    Slot slots_[kMaxReaders];
+    mutable std::mutex retiredMu_;
+    std::vector<Retired> retired_;
+};
+
+// Single pointer published RCU-style: readers pin() and see one consistent
+// object for as long as the pin lives; publish() swaps in a new object and
+// retires the old one to the domain. Writers never wait for readers.
+template <class T>
+class RcuCell {
+public:
+    explicit RcuCell(std::unique_ptr<T> initial) : current_(initial.release()) {}
+    ~RcuCell() { delete current_.load(std::memory_order_acquire); }
+
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    class Pin {
+    public:
+        const T& operator*() const { return *p_; }
+        const T* operator->() const { return p_; }
+        const T* get() const { return p_; }
+
+    private:
+        friend class RcuCell;
+        Pin(EpochDomain::Guard g, const T* p) : guard_(std::move(g)), p_(p) {}
+        EpochDomain::Guard guard_;
+        const T* p_;
+    };
+
+    Pin pin() const {
+        auto g = epochs_.pin();
+        return Pin(std::move(g), current_.load(std::memory_order_seq_cst));
+    }
+
+    void publish(std::unique_ptr<T> next) {
+        const T* old = current_.exchange(next.release(), std::memory_order_seq_cst);
+        epochs_.retire([old]{ delete old; });
+    }
+
+    size_t pendingReclaim() const { return epochs_.pending(); }
+
+private:
+    // Declared first so it is destroyed last, after current_ is deleted
+    mutable EpochDomain epochs_;
+    std::atomic<const T*> current_;
+};
@@ -0,0 +1,99 @@
+#include "geodesy.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// WGS-84
+constexpr double kA  = 6378137.0;                // semi-major axis (m)
+constexpr double kE2 = 6.69437999014e-3;         // first eccentricity squared
+constexpr double kDeg = 3.14159265358979323846 / 180.0;
+
+// Round to nearest without a rounding instruction (SSE2 has none), valid
+// for |x| < 2^51: adding 1.5 * 2^52 pushes the fraction out of the mantissa
+constexpr double kRound = 6755399441055744.0;
+
+} // namespace
+
+LocalFrame::LocalFrame(double lat_deg, double lon_deg, double alt_m)
+    : lat_deg_(lat_deg), lon_deg_(lon_deg), alt_m_(alt_m) {
+    if (!(std::fabs(lat_deg) <= 90.0) || !std::isfinite(lon_deg) || !std::isfinite(alt_m)) {
+        throw std::invalid_argument("Bad origin: latitude must be within +-90 degrees");
+    }
+    sinLat0_ = std::sin(lat_deg * kDeg);
+    cosLat0_ = std::cos(lat_deg * kDeg);
+    const double n0 = kA / std::sqrt(1.0 - kE2 * sinLat0_ * sinLat0_);
+    x0_ = (n0 + alt_m) * cosLat0_;
+    z0_ = (n0 * (1.0 - kE2) + alt_m) * sinLat0_;
+}
+
+LocalFrame LocalFrame::parse(const std::string& spec) {
+    std::stringstream ss(spec);
+    std::string tok;
+    std::vector<double> v;
+    while (std::getline(ss, tok, ',')) {
+        tok = trim(tok);
+        if (!isNumeric(tok)) throw std::invalid_argument("Bad origin (want lat,lon[,alt_m]): " + spec);
+        v.push_back(std::stod(tok));
+    }
+    if (v.size() < 2 || v.size() > 3) throw std::invalid_argument("Bad origin (want lat,lon[,alt_m]): " + spec);
+    return LocalFrame(v[0], v[1], v.size() == 3 ? v[2] : 0.0);
+}
+
+// Outputs never alias the inputs; without the promise the loop needs more
+// runtime overlap checks than GCC is willing to emit
+void LocalFrame::toENU(size_t n, const double* lat_deg, const double* lon_deg, const double* alt_m,
+                       double* __restrict east_km, double* __restrict north_km,
+                       double* __restrict range_km) const {
+    const double lon0 = lon_deg_, s0 = sinLat0_, c0 = cosLat0_, x0 = x0_, z0 = z0_;
+    for (size_t i = 0; i < n; ++i) {
+        // Longitude difference wrapped into [-180, 180]
+        double dl = lon_deg[i] - lon0;
+        dl -= 360.0 * ((dl * (1.0 / 360.0) + kRound) - kRound);
+
+        const double phi = lat_deg[i] * kDeg, lam = dl * kDeg, h = alt_m[i];
+        const double sp = fastSin(phi), cp = fastCos(phi);
+        const double sl = fastSin(lam), cl = fastCos(lam);
+        const double nu = kA / std::sqrt(1.0 - kE2 * sp * sp);   // prime vertical radius
+
+        // Rotated ECEF relative to the origin, then into east-north-up
+        const double dx = (nu + h) * cp * cl - x0;
+        const double y  = (nu + h) * cp * sl;
+        const double dz = (nu * (1.0 - kE2) + h) * sp - z0;
+        const double north = c0 * dz - s0 * dx;
+        const double up    = c0 * dx + s0 * dz;
+
+        east_km[i]  = y * 1e-3;
+        north_km[i] = north * 1e-3;
+        range_km[i] = std::sqrt(y * y + north * north + up * up) * 1e-3;
+    }
+}
+
+void LocalFrame::convert(std::vector<Update>& batch) const {
+    constexpr size_t kBlock = 256;
+    double lat[kBlock] = {}, lon[kBlock] = {}, alt[kBlock] = {};
+    double e[kBlock], nn[kBlock], r[kBlock];
+    Contact* cs[kBlock] = {};
+    size_t m = 0;
+    auto flush = [&]() {
+        toENU(m, lat, lon, alt, e, nn, r);
+        for (size_t i = 0; i < m; ++i) {
+            cs[i]->has_pos  = true;
+            cs[i]->east_km  = e[i];
+            cs[i]->north_km = nn[i];
+            cs[i]->range_km = r[i];
+        }
+        m = 0;
+    };
+    for (Update& u : batch) {
+        if (!u.c.has_geo) continue;
+        cs[m]  = &u.c;
+        lat[m] = u.c.lat_deg;
+        lon[m] = u.c.lon_deg;
+        alt[m] = u.c.altitude_m;
+        if (++m == kBlock) flush();
+    }
+    flush();
+}
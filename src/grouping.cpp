@@ -0,0 +1,162 @@
+#include "grouping.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+#include "common.hpp"
+
+namespace {
+
+// Worker w's slice of n items
+std::pair<size_t, size_t> slice(size_t n, size_t workers, size_t w) {
+    return { n * w / workers, n * (w + 1) / workers };
+}
+
+constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+} // namespace
+
+TrackGrouper::TrackGrouper(GroupParams p, size_t threads)
+    : p_(p), threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+template <class Fn>
+void TrackGrouper::forNeighbours(size_t i, Fn fn) const {
+    const Point& a = points_[i];
+    const double invPos2 = 1.0 / (p_.eps_km * p_.eps_km);
+    const double epsV = p_.eps_mps / 1000.0;   // km/s, like the velocities
+    const double invVel2 = 1.0 / (epsV * epsV);
+    const int64_t cx = cellOf(a.e, p_.eps_km), cy = cellOf(a.n, p_.eps_km);
+    // Neighbouring cells can share a bucket; visit each bucket once
+    uint32_t seen[9];
+    size_t nSeen = 0;
+    for (int64_t dx = -1; dx <= 1; ++dx) {
+        for (int64_t dy = -1; dy <= 1; ++dy) {
+            const uint32_t b = bucketOf(cx + dx, cy + dy, bits_);
+            if (std::find(seen, seen + nSeen, b) != seen + nSeen) continue;
+            seen[nSeen++] = b;
+            for (uint32_t j = start_[b]; j < start_[b + 1]; ++j) {
+                const Point& o = points_[j];
+                const double de = o.e - a.e, dn = o.n - a.n;
+                const double pos2 = (de * de + dn * dn) * invPos2;
+                if (pos2 > 1.0) continue;
+                const double dve = o.ve - a.ve, dvn = o.vn - a.vn;
+                const double vel2 = (dve * dve + dvn * dvn) * invVel2;
+                if (vel2 <= 1.0) fn(j, pos2 + vel2);
+            }
+        }
+    }
+}
+
+uint32_t TrackGrouper::find(uint32_t i) {
+    while (parent_[i] != i) {
+        parent_[i] = parent_[parent_[i]];   // path halving
+        i = parent_[i];
+    }
+    return i;
+}
+
+void TrackGrouper::run(const TrackStore& store, const TrackMotion& motion, double t) {
+    // Grid the eligible tracks
+    keyed_.clear();
+    for (TrackHandle h = 0; h < store.size(); ++h) {
+        if (!store.has_pos[h] || !motion.hasVelocity(h) || t - store.last_seen[h] > p_.maxAge_s) continue;
+        keyed_.push_back(h);
+    }
+    bits_ = 4;
+    while ((size_t{1} << bits_) < 2 * keyed_.size()) ++bits_;
+    for (uint64_t& k : keyed_) {
+        const TrackHandle h = static_cast<TrackHandle>(k);
+        const uint32_t b = bucketOf(cellOf(store.east_km[h], p_.eps_km),
+                                    cellOf(store.north_km[h], p_.eps_km), bits_);
+        k |= static_cast<uint64_t>(b) << 32;
+    }
+    const size_t buckets = size_t{1} << bits_;
+    start_.assign(buckets + 1, 0);
+    for (uint64_t k : keyed_) ++start_[(k >> 32) + 1];
+    for (size_t b = 1; b <= buckets; ++b) start_[b] += start_[b - 1];
+    points_.resize(keyed_.size());
+    {
+        std::vector<uint32_t> fill(start_.begin(), start_.end() - 1);
+        for (uint64_t k : keyed_) {
+            const TrackHandle h = static_cast<TrackHandle>(k);
+            points_[fill[k >> 32]++] = { store.east_km[h], store.north_km[h],
+                                         motion.velE(h), motion.velN(h), h };
+        }
+    }
+    const size_t n = points_.size();
+    const size_t workers = std::max<size_t>(1, std::min(threads_, n / 4096 + 1));
+
+    // 1. Core points (parallel)
+    core_.assign(n, 0);
+    parallel(workers, [&](size_t w) {
+        auto [lo, hi] = slice(n, workers, w);
+        for (size_t i = lo; i < hi; ++i) {
+            size_t count = 0;
+            forNeighbours(i, [&](uint32_t, double) { ++count; });
+            core_[i] = count >= p_.minPts;
+        }
+    });
+
+    // 2. Core-core edges and each border point's nearest core (parallel)
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> edges(workers);
+    std::vector<uint32_t> borderOf(n, kNone);
+    parallel(workers, [&](size_t w) {
+        auto [lo, hi] = slice(n, workers, w);
+        for (size_t i = lo; i < hi; ++i) {
+            if (core_[i]) {
+                forNeighbours(i, [&](uint32_t j, double) {
+                    if (j > i && core_[j]) edges[w].emplace_back(static_cast<uint32_t>(i), j);
+                });
+            } else {
+                double best = std::numeric_limits<double>::infinity();
+                forNeighbours(i, [&](uint32_t j, double d2) {
+                    if (core_[j] && (d2 < best || (d2 == best && j < borderOf[i]))) {
+                        best = d2;
+                        borderOf[i] = j;
+                    }
+                });
+            }
+        }
+    });
+
+    // 3. Join the edges
+    parent_.resize(n);
+    for (uint32_t i = 0; i < n; ++i) parent_[i] = i;
+    for (const auto& list : edges) {
+        for (auto [a, b] : list) {
+            const uint32_t ra = find(a), rb = find(b);
+            if (ra != rb) parent_[std::max(ra, rb)] = std::min(ra, rb);
+        }
+    }
+
+    // 4. Groups and their aggregates
+    std::vector<uint32_t> groupOf(n, kNone);
+    groups_.clear();
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint32_t c = core_[i] ? i : borderOf[i];
+        if (c == kNone) continue;
+        const uint32_t r = find(c);
+        if (groupOf[r] == kNone) {
+            groupOf[r] = static_cast<uint32_t>(groups_.size());
+            groups_.emplace_back();
+        }
+        groups_[groupOf[r]].members.push_back(points_[i].h);
+    }
+    for (TrackGroup& g : groups_) {
+        std::sort(g.members.begin(), g.members.end(), [&](TrackHandle a, TrackHandle b) {
+            return store.score[a] != store.score[b] ? store.score[a] > store.score[b] : a < b;
+        });
+        g.id = *std::min_element(g.members.begin(), g.members.end());
+        g.max_score = store.score[g.members.front()];
+        double sum = 0.0;
+        for (TrackHandle h : g.members) sum += store.score[h];
+        g.mean_score = sum / static_cast<double>(g.members.size());
+    }
+    std::sort(groups_.begin(), groups_.end(), [](const TrackGroup& a, const TrackGroup& b) {
+        if (a.max_score != b.max_score) return a.max_score > b.max_score;
+        if (a.members.size() != b.members.size()) return a.members.size() > b.members.size();
+        return a.id < b.id;
+    });
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "track_filter.hpp"
+#include "track_store.hpp"
+
+// -------------------- Track Grouping --------------------
+// Density clustering (DBSCAN) of tracks moving together. Two tracks are
+// neighbours when their positions are within eps_km and their ground
+// velocities within eps_mps. A core track has at least minPts neighbours,
+// counting itself. Core tracks that are neighbours share a group, and a
+// non-core track joins the group of its nearest core neighbour. Tracks
+// without a position, a velocity or a report in the last maxAge_s are
+// never grouped.
+//
+// The tracks are bucketed into a hashed grid of eps-sized cells, so
+// neighbours are found in the 3 x 3 cells around a track. Neighbour
+// counting and edge finding run in parallel over slices of the grid; the
+// union-find pass that joins the edges runs alone.
+struct GroupParams {
+    double eps_km = 3.0;
+    double eps_mps = 60.0;
+    size_t minPts = 3;
+    double maxAge_s = 30.0;
+};
+
+struct TrackGroup {
+    TrackHandle id;                     // lowest member handle: stable while it stays
+    std::vector<TrackHandle> members;   // best score first
+    double max_score = 0.0;
+    double mean_score = 0.0;
+};
+
+class TrackGrouper {
+public:
+    explicit TrackGrouper(GroupParams p = {}, size_t threads = 0);   // 0 = hardware threads
+
+    void run(const TrackStore& store, const TrackMotion& motion, double t);
+
+    // By descending max score, ties to the larger group
+    const std::vector<TrackGroup>& groups() const { return groups_; }
+
+private:
+    struct Point {
+        double e, n, ve, vn;            // km, km/s
+        TrackHandle h;
+    };
+
+    // Calls fn(j, d2) for every neighbour j of point i (i included)
+    template <class Fn>
+    void forNeighbours(size_t i, Fn fn) const;
+
+    uint32_t find(uint32_t i);
+
+    GroupParams p_;
+    size_t threads_;
+    unsigned bits_ = 0;
+    std::vector<Point> points_;         // bucket order
+    std::vector<uint32_t> start_;       // bucket b is [start_[b], start_[b + 1])
+    std::vector<uint64_t> keyed_;       // bucket << 32 | handle, unsorted
+    std::vector<uint8_t> core_;
+    std::vector<uint32_t> parent_;      // union-find over point indices
+    std::vector<TrackGroup> groups_;
+};
@@ -0,0 +1,104 @@
+#include "hugepages.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+std::atomic<HugePages> gMode{HugePages::Off};
+std::atomic<uint64_t> gHugetlb{0}, gThp{0}, gPlain{0};
+
+// Backing of a live mapping, recorded in its last byte. Mappings are
+// rounded up to whole huge pages with at least one spare byte for it.
+enum Backing : uint8_t { kHugetlb = 1, kThp = 2, kPlain = 3 };
+
+size_t mappedBytes(size_t bytes) {
+    return (bytes + 1 + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+}
+
+std::atomic<uint64_t>& counter(uint8_t b) {
+    return b == kHugetlb ? gHugetlb : b == kThp ? gThp : gPlain;
+}
+
+#ifdef __linux__
+void* mapAnon(size_t len, int extra) {
+    void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+}
+
+// Map len bytes at a 2 MiB boundary so THP can back every page of it
+void* mapAligned(size_t len) {
+    char* raw = static_cast<char*>(mapAnon(len + kHugePageBytes, 0));
+    if (!raw) return nullptr;
+    uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (addr + kHugePageBytes - 1) & ~(uintptr_t(kHugePageBytes) - 1);
+    size_t head = aligned - addr;
+    if (head) munmap(raw, head);
+    if (kHugePageBytes - head) munmap(reinterpret_cast<char*>(aligned) + len, kHugePageBytes - head);
+    return reinterpret_cast<void*>(aligned);
+}
+#endif
+
+} // namespace
+
+void setHugePages(HugePages mode) { gMode.store(mode, std::memory_order_relaxed); }
+HugePages hugePages() { return gMode.load(std::memory_order_relaxed); }
+
+HugePageStats hugePageStats() {
+    return { gHugetlb.load(std::memory_order_relaxed), gThp.load(std::memory_order_relaxed),
+             gPlain.load(std::memory_order_relaxed) };
+}
+
+long anonHugePagesKb() {
+    std::ifstream in("/proc/self/smaps_rollup");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("AnonHugePages:", 0) == 0) {
+            std::istringstream ss(line.substr(14));
+            long kb = -1;
+            ss >> kb;
+            return kb;
+        }
+    }
+    return -1;
+}
+
+void* hugeAllocate(size_t bytes) {
+#ifdef __linux__
+    if (bytes >= kHugePageBytes) {
+        const size_t len = mappedBytes(bytes);
+        void* p = nullptr;
+        uint8_t backing = kPlain;
+        if (hugePages() == HugePages::On) {
+            if ((p = mapAnon(len, MAP_HUGETLB))) {
+                backing = kHugetlb;
+            } else if ((p = mapAligned(len))) {
+                backing = madvise(p, len, MADV_HUGEPAGE) == 0 ? kThp : kPlain;
+            }
+        }
+        if (!p && !(p = mapAnon(len, 0))) throw std::bad_alloc();
+        static_cast<uint8_t*>(p)[len - 1] = backing;
+        counter(backing).fetch_add(len, std::memory_order_relaxed);
+        return p;
+    }
+#endif
+    return ::operator new(bytes);
+}
+
+void hugeDeallocate(void* p, size_t bytes) {
+    if (!p) return;
+#ifdef __linux__
+    if (bytes >= kHugePageBytes) {
+        const size_t len = mappedBytes(bytes);
+        counter(static_cast<uint8_t*>(p)[len - 1]).fetch_sub(len, std::memory_order_relaxed);
+        munmap(p, len);
+        return;
+    }
+#endif
+    ::operator delete(p);
+}
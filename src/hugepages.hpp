@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+// -------------------- Huge Page Backing --------------------
+// Large column allocations (>= one 2 MiB page) are mmapped directly so they
+// can be backed by huge pages when enabled: hugetlbfs pages first
+// (MAP_HUGETLB, needs pages reserved in vm.nr_hugepages), else a 2 MiB
+// aligned mapping advised with MADV_HUGEPAGE for transparent huge pages,
+// else plain pages. Small allocations go through operator new as usual.
+enum class HugePages { Off, On };
+
+constexpr size_t kHugePageBytes = size_t(2) << 20;
+
+// Process-wide policy for allocations made from now on.
+void setHugePages(HugePages mode);
+HugePages hugePages();
+
+// Bytes currently mapped through each backing.
+struct HugePageStats {
+    uint64_t hugetlb = 0;
+    uint64_t thp = 0;      // advised; the kernel may still fall back
+    uint64_t plain = 0;
+};
+HugePageStats hugePageStats();
+
+// AnonHugePages from /proc/self/smaps_rollup in KiB, or -1 if unreadable.
+long anonHugePagesKb();
+
+void* hugeAllocate(size_t bytes);
+void hugeDeallocate(void* p, size_t bytes);
+
+template <class T>
+struct HugePageAllocator {
+    using value_type = T;
+
+    HugePageAllocator() = default;
+    template <class U> HugePageAllocator(const HugePageAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) throw std::bad_alloc();
+        return static_cast<T*>(hugeAllocate(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) { hugeDeallocate(p, n * sizeof(T)); }
+
+    template <class U> bool operator==(const HugePageAllocator<U>&) const { return true; }
+    template <class U> bool operator!=(const HugePageAllocator<U>&) const { return false; }
+};
+
+template <class T>
+using HugeVector = std::vector<T, HugePageAllocator<T>>;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+
+// -------------------- Fixed-Size Matrices --------------------
+// Row-major R x C matrix with its shape in the type. Every loop below has a
+// constant trip count, so the compiler unrolls them completely and a
+// filter step over these is straight-line code that can be vectorized
+// across tracks.
+template <size_t R, size_t C>
+struct Mat {
+    double a[R][C];
+
+    double& operator()(size_t r, size_t c) { return a[r][c]; }
+    double operator()(size_t r, size_t c) const { return a[r][c]; }
+
+    static Mat identity() {
+        Mat m{};
+        for (size_t i = 0; i < (R < C ? R : C); ++i) m.a[i][i] = 1.0;
+        return m;
+    }
+};
+
+template <size_t R, size_t K, size_t C>
+Mat<R, C> operator*(const Mat<R, K>& x, const Mat<K, C>& y) {
+    Mat<R, C> o{};
+    for (size_t r = 0; r < R; ++r)
+        for (size_t c = 0; c < C; ++c)
+            for (size_t k = 0; k < K; ++k) o.a[r][c] += x.a[r][k] * y.a[k][c];
+    return o;
+}
+
+template <size_t R, size_t C>
+Mat<R, C> operator*(double s, const Mat<R, C>& x) {
+    Mat<R, C> o;
+    for (size_t r = 0; r < R; ++r)
+        for (size_t c = 0; c < C; ++c) o.a[r][c] = s * x.a[r][c];
+    return o;
+}
+
+template <size_t R, size_t C>
+Mat<R, C> operator+(const Mat<R, C>& x, const Mat<R, C>& y) {
+    Mat<R, C> o;
+    for (size_t r = 0; r < R; ++r)
+        for (size_t c = 0; c < C; ++c) o.a[r][c] = x.a[r][c] + y.a[r][c];
+    return o;
+}
+
+template <size_t R, size_t C>
+Mat<R, C> operator-(const Mat<R, C>& x, const Mat<R, C>& y) {
+    Mat<R, C> o;
+    for (size_t r = 0; r < R; ++r)
+        for (size_t c = 0; c < C; ++c) o.a[r][c] = x.a[r][c] - y.a[r][c];
+    return o;
+}
+
+template <size_t R, size_t C>
+Mat<C, R> transpose(const Mat<R, C>& x) {
+    Mat<C, R> o;
+    for (size_t r = 0; r < R; ++r)
+        for (size_t c = 0; c < C; ++c) o.a[c][r] = x.a[r][c];
+    return o;
+}
+
+// Scalar measurements make the innovation covariance 1 x 1
+inline Mat<1, 1> inverse(const Mat<1, 1>& x) { return {{{ 1.0 / x.a[0][0] }}}; }
@@ -0,0 +1,215 @@
+#include "numa.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// "0-3,8-11" -> {0,1,2,3,8,9,10,11}; also used for node lists
+std::vector<int> parseCpuList(const std::string& s) {
+    std::vector<int> out;
+    std::stringstream ss(s);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        part = trim(part);
+        if (part.empty()) continue;
+        auto dash = part.find('-');
+        int lo = std::stoi(part.substr(0, dash));
+        int hi = dash == std::string::npos ? lo : std::stoi(part.substr(dash + 1));
+        for (int c = lo; c <= hi; ++c) out.push_back(c);
+    }
+    return out;
+}
+
+// Handles [first, first + count) of partition p when n handles are split
+// over parts partitions.
+std::pair<size_t, size_t> split(size_t n, size_t parts, size_t p) {
+    size_t base = n / parts, extra = n % parts;
+    size_t first = p * base + std::min(p, extra);
+    return { first, base + (p < extra ? 1 : 0) };
+}
+
+} // namespace
+
+NumaTopology NumaTopology::detect() {
+    NumaTopology t;
+    // Node numbers can have gaps (0,2 with node 1 offline), so take them
+    // from the online list rather than counting up
+    std::vector<int> online;
+    if (std::ifstream in("/sys/devices/system/node/online"); in) {
+        std::string line;
+        std::getline(in, line);
+        online = parseCpuList(line);
+    }
+    for (int node : online) {
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!in) continue;
+        std::string line;
+        std::getline(in, line);
+        auto cpus = parseCpuList(line);
+        if (!cpus.empty()) t.cpus.push_back(std::move(cpus));
+    }
+    if (t.cpus.empty()) {
+        unsigned n = std::max(1u, std::thread::hardware_concurrency());
+        t.cpus.emplace_back();
+        for (unsigned c = 0; c < n; ++c) t.cpus[0].push_back(static_cast<int>(c));
+    }
+    return t;
+}
+
+bool pinCurrentThread(const std::vector<int>& cpus) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) CPU_SET(c, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+// -------------------- PinnedPool --------------------
+PinnedPool::PinnedPool(const NumaTopology& topo, size_t threadsPerNode)
+    : nodes_(topo.nodes()), perNode_(std::max<size_t>(1, threadsPerNode)) {
+    for (size_t n = 0; n < nodes_; ++n) {
+        for (size_t w = 0; w < perNode_; ++w) {
+            threads_.emplace_back([this, n, w, cpus = topo.cpus[n]]{ loop(n, w, cpus); });
+        }
+    }
+}
+
+PinnedPool::~PinnedPool() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+void PinnedPool::run(const Task& task) {
+    std::unique_lock<std::mutex> lk(mu_);
+    task_ = &task;
+    remaining_ = threads_.size();
+    ++generation_;
+    cv_.notify_all();
+    doneCv_.wait(lk, [this]{ return remaining_ == 0; });
+    task_ = nullptr;
+}
+
+void PinnedPool::loop(size_t node, size_t worker, std::vector<int> cpus) {
+    // Pin to the node rather than a single CPU so the scheduler can still
+    // balance within the socket
+    pinCurrentThread(cpus);
+
+    uint64_t seen = 0;
+    for (;;) {
+        const Task* task;
+        {
+            std::unique_lock<std::mutex> lk(mu_);
+            cv_.wait(lk, [&]{ return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            task = task_;
+        }
+        (*task)(node, worker, perNode_);
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            if (--remaining_ == 0) doneCv_.notify_one();
+        }
+    }
+}
+
+// -------------------- NumaScorer --------------------
+void keepTopK(std::vector<std::pair<double, TrackHandle>>& v, size_t k) {
+    auto better = [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    };
+    if (v.size() > k) {
+        std::nth_element(v.begin(), v.begin() + k, v.end(), better);
+        v.resize(k);
+    }
+    std::sort(v.begin(), v.end(), better);
+}
+
+void NumaScorer::load(const TrackStore& store) {
+    tracks_ = store.size();
+    parts_.assign(pool_.nodes(), Partition{});
+    for (size_t n = 0; n < parts_.size(); ++n) {
+        auto [first, count] = split(tracks_, parts_.size(), n);
+        parts_[n].first = static_cast<TrackHandle>(first);
+        parts_[n].count = count;
+    }
+
+    // Worker 0 of each node allocates its partition's columns; resize()
+    // zero-fills them, so the pages are first touched on the owning node.
+    pool_.run([&](size_t node, size_t worker, size_t) {
+        if (worker != 0) return;
+        Partition& p = parts_[node];
+        p.range_km.resize(p.count);
+        p.closing_mps.resize(p.count);
+        p.altitude_m.resize(p.count);
+        p.rcs_m2.resize(p.count);
+        p.score.resize(p.count);
+        p.iff.resize(p.count);
+        p.platform.resize(p.count);
+    });
+    // Then every worker of the node copies in its own slice
+    pool_.run([&](size_t node, size_t worker, size_t workers) {
+        Partition& p = parts_[node];
+        auto [lo, cnt] = split(p.count, workers, worker);
+        for (size_t i = lo; i < lo + cnt; ++i) {
+            const TrackHandle h = p.first + static_cast<TrackHandle>(i);
+            p.range_km[i]    = store.range_km[h];
+            p.closing_mps[i] = store.closing_mps[h];
+            p.altitude_m[i]  = store.altitude_m[h] - store.terrain_m[h];   // above ground, as scored
+            p.rcs_m2[i]      = store.rcs_m2[h];
+            p.iff[i]         = store.iff[h];
+            p.platform[i]    = store.platform[h];
+        }
+    });
+}
+
+std::vector<std::pair<double, TrackHandle>> NumaScorer::scoreTopK(const Weights& w, size_t k) {
+    k = std::max<size_t>(k, 1);
+    const size_t workers = pool_.threadsPerNode();
+    std::vector<std::vector<std::pair<double, TrackHandle>>> local(pool_.nodes() * workers);
+
+    pool_.run([&](size_t node, size_t worker, size_t nw) {
+        Partition& p = parts_[node];
+        auto [lo, cnt] = split(p.count, nw, worker);
+        auto& top = local[node * workers + worker];
+        top.reserve(2 * k);
+        for (size_t i = lo; i < lo + cnt; ++i) {
+            double s = scoreFromFeatures(
+                scoreFeatures(p.range_km[i], p.iff[i], p.closing_mps[i], p.altitude_m[i], p.rcs_m2[i],
+                              p.platform[i]), w);
+            p.score[i] = s;
+            top.emplace_back(s, p.first + static_cast<TrackHandle>(i));
+            if (top.size() >= 2 * k) keepTopK(top, k);   // bounded memory
+        }
+        keepTopK(top, k);
+    });
+
+    // Per-node merge, then across nodes
+    std::vector<std::pair<double, TrackHandle>> global;
+    for (size_t n = 0; n < pool_.nodes(); ++n) {
+        std::vector<std::pair<double, TrackHandle>> node;
+        for (size_t w2 = 0; w2 < workers; ++w2) {
+            auto& l = local[n * workers + w2];
+            node.insert(node.end(), l.begin(), l.end());
+        }
+        keepTopK(node, k);
+        global.insert(global.end(), node.begin(), node.end());
+    }
+    keepTopK(global, k);
+    return global;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "scoring.hpp"
+#include "track_store.hpp"
+
+// -------------------- NUMA Partitioning --------------------
+// Without libnuma: the topology comes from /sys, threads are pinned with
+// sched affinity, and memory placement relies on the kernel's first-touch
+// policy (a page lands on the node of the thread that first writes it).
+struct NumaTopology {
+    std::vector<std::vector<int>> cpus;   // per node
+
+    size_t nodes() const { return cpus.size(); }
+
+    // The nodes in /sys/devices/system/node/online, in order; one node with
+    // every CPU if unavailable
+    static NumaTopology detect();
+};
+
+// Pin the calling thread to the given CPUs. Returns false if refused.
+bool pinCurrentThread(const std::vector<int>& cpus);
+
+// Persistent worker threads, threadsPerNode of them pinned to each node.
+class PinnedPool {
+public:
+    using Task = std::function<void(size_t node, size_t worker, size_t workersInNode)>;
+
+    PinnedPool(const NumaTopology& topo, size_t threadsPerNode);
+    ~PinnedPool();
+
+    // Run task on every worker; returns when all have finished.
+    void run(const Task& task);
+
+    size_t nodes() const { return nodes_; }
+    size_t threadsPerNode() const { return perNode_; }
+
+private:
+    void loop(size_t node, size_t worker, std::vector<int> cpus);
+
+    size_t nodes_;
+    size_t perNode_;
+    std::vector<std::thread> threads_;
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::condition_variable doneCv_;
+    const Task* task_ = nullptr;
+    uint64_t generation_ = 0;
+    size_t remaining_ = 0;
+    bool stop_ = false;
+};
+
+// Track columns split into one contiguous handle range per node. Each
+// partition is allocated and first-touched by that node's workers, and only
+// they score it; every worker keeps a local top-K, each node merges its
+// workers' lists and the caller merges the per-node lists.
+class NumaScorer {
+public:
+    explicit NumaScorer(PinnedPool& pool) : pool_(pool) {}
+
+    // Copy the store's scoring inputs into node-local partitions.
+    void load(const TrackStore& store);
+
+    // Score everything; returns the global top-K, best first.
+    std::vector<std::pair<double, TrackHandle>> scoreTopK(const Weights& w, size_t k);
+
+    size_t tracks() const { return tracks_; }
+
+private:
+    struct Partition {
+        TrackHandle first = 0;
+        size_t count = 0;
+        HugeVector<double> range_km, closing_mps, altitude_m, rcs_m2, score;   // altitude above ground
+        HugeVector<IFF> iff;
+        HugeVector<Platform> platform;
+    };
+
+    PinnedPool& pool_;
+    size_t tracks_ = 0;
+    std::vector<Partition> parts_;   // one per node
+};
+
+// Best k of a list of (score, handle), best first; ties by handle.
+void keepTopK(std::vector<std::pair<double, TrackHandle>>& v, size_t k);
@@ -0,0 +1,91 @@
+#include "perf_counters.hpp"
+
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+int openEvent(PerfCounters::Event e) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    switch (e) {
+        case PerfCounters::Event::CacheMisses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PerfCounters::Event::DtlbLoadMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB
+                        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+    }
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#else
+int openEvent(PerfCounters::Event) { return -1; }
+#endif
+
+} // namespace
+
+PerfCounters::PerfCounters(const std::vector<Event>& events) {
+    for (Event e : events) counters_.push_back({e, openEvent(e), 0});
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (auto& c : counters_) if (c.fd >= 0) close(c.fd);
+#endif
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+    for (auto& c : counters_) {
+        if (c.fd < 0) continue;
+        ioctl(c.fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(c.fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+void PerfCounters::stop() {
+#ifdef __linux__
+    for (auto& c : counters_) {
+        if (c.fd < 0) continue;
+        ioctl(c.fd, PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t v = 0;
+        if (read(c.fd, &v, sizeof(v)) == static_cast<ssize_t>(sizeof(v))) c.value = v;
+    }
+#endif
+}
+
+bool PerfCounters::available(Event e) const {
+    for (const auto& c : counters_) if (c.event == e) return c.fd >= 0;
+    return false;
+}
+
+uint64_t PerfCounters::value(Event e) const {
+    for (const auto& c : counters_) if (c.event == e) return c.value;
+    return 0;
+}
+
+std::string PerfCounters::perUnit(Event e, double units) const {
+    if (!available(e) || units <= 0.0) return "n/a";
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(2) << value(e) / units;
+    return os.str();
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// -------------------- Hardware Counters --------------------
+// Thin wrapper over Linux perf_event_open for benchmark output (user-space
+// events of the calling thread only). Events the kernel or VM does not
+// expose are reported as unavailable rather than failing the benchmark.
+class PerfCounters {
+public:
+    enum class Event { CacheMisses, DtlbLoadMisses };
+
+    explicit PerfCounters(const std::vector<Event>& events);
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    void start();
+    void stop();
+
+    bool available(Event e) const;
+    uint64_t value(Event e) const;
+
+    // "12.34" per unit, or "n/a" if the event could not be opened
+    std::string perUnit(Event e, double units) const;
+
+private:
+    struct Counter {
+        Event event;
+        int fd;
+        uint64_t value;
+    };
+    std::vector<Counter> counters_;
+};
@@ -0,0 +1,179 @@
+#include "profile.hpp"
+
+#include <sys/stat.h>
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Setter = void (*)(Profile&, double);
+
+// Every class except those with a built-in value of their own for the field
+// (the missile ranges); those change only through "<class>.<key>"
+void setAll(Profile& p, double ThresholdSet::*field, double v) {
+    static const ThresholdSet base;
+    static const Thresholds builtin;
+    for (size_t k = 0; k < kPlatforms; ++k) {
+        if (builtin.byPlatform[k].*field == base.*field) p.thresholds.byPlatform[k].*field = v;
+    }
+}
+
+const std::unordered_map<std::string, Setter>& setters() {
+    static const std::unordered_map<std::string, Setter> table = {
+        {"w_range_inv",           [](Profile& p, double v){ p.weights.w_range_inv = v; }},
+        {"w_closing",             [](Profile& p, double v){ p.weights.w_closing = v; }},
+        {"w_rcs",                 [](Profile& p, double v){ p.weights.w_rcs = v; }},
+        {"w_iff_friend",          [](Profile& p, double v){ p.weights.w_iff[size_t(IFF::Friend)] = v; }},
+        {"w_iff_unknown",         [](Profile& p, double v){ p.weights.w_iff[size_t(IFF::Unknown)] = v; }},
+        {"w_iff_foe",             [](Profile& p, double v){ p.weights.w_iff[size_t(IFF::Foe)] = v; }},
+        {"w_iff_pending",         [](Profile& p, double v){ p.weights.w_iff[size_t(IFF::Pending)] = v; }},
+        {"w_iff_assumed_friend",  [](Profile& p, double v){ p.weights.w_iff[size_t(IFF::AssumedFriend)] = v; }},
+        {"w_iff_neutral",         [](Profile& p, double v){ p.weights.w_iff[size_t(IFF::Neutral)] = v; }},
+        {"w_iff_suspect",         [](Profile& p, double v){ p.weights.w_iff[size_t(IFF::Suspect)] = v; }},
+        {"w_iff_joker",           [](Profile& p, double v){ p.weights.w_iff[size_t(IFF::Joker)] = v; }},
+        {"w_iff_faker",           [](Profile& p, double v){ p.weights.w_iff[size_t(IFF::Faker)] = v; }},
+        {"w_alt_low",             [](Profile& p, double v){ p.weights.w_alt_low = v; }},
+        // Plain threshold keys set every class without a built-in value
+        {"intercept_score",       [](Profile& p, double v){ setAll(p, &ThresholdSet::intercept_score, v); }},
+        {"intercept_range_km",    [](Profile& p, double v){ setAll(p, &ThresholdSet::intercept_range_km, v); }},
+        {"intercept_closing_mps", [](Profile& p, double v){ setAll(p, &ThresholdSet::intercept_closing_mps, v); }},
+        {"elevated_score",        [](Profile& p, double v){ setAll(p, &ThresholdSet::elevated_score, v); }},
+        {"elevated_range_km",     [](Profile& p, double v){ setAll(p, &ThresholdSet::elevated_range_km, v); }},
+    };
+    return table;
+}
+
+// "<class>.<key>" entries: one platform class's weights and thresholds
+using ClassSetter = void (*)(Profile&, size_t, double);
+
+const std::unordered_map<std::string, ClassSetter>& classSetters() {
+    static const std::unordered_map<std::string, ClassSetter> table = {
+        {"w_platform",            [](Profile& p, size_t k, double v){ p.weights.w_platform[k] = v; }},
+        {"rcs_scale",             [](Profile& p, size_t k, double v){ p.weights.rcs_scale[k] = v; }},
+        {"intercept_score",       [](Profile& p, size_t k, double v){ p.thresholds.byPlatform[k].intercept_score = v; }},
+        {"intercept_range_km",    [](Profile& p, size_t k, double v){ p.thresholds.byPlatform[k].intercept_range_km = v; }},
+        {"intercept_closing_mps", [](Profile& p, size_t k, double v){ p.thresholds.byPlatform[k].intercept_closing_mps = v; }},
+        {"elevated_score",        [](Profile& p, size_t k, double v){ p.thresholds.byPlatform[k].elevated_score = v; }},
+        {"elevated_range_km",     [](Profile& p, size_t k, double v){ p.thresholds.byPlatform[k].elevated_range_km = v; }},
+    };
+    return table;
+}
+
+// mtime in ns, or -1 if the file is missing
+int64_t mtimeNs(const std::string& path) {
+    struct stat st {};
+    if (::stat(path.c_str(), &st) != 0) return -1;
+    return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+} // namespace
+
+Profile loadProfile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Failed to open profile: " + path);
+    }
+
+    Profile p;
+    std::vector<std::tuple<ClassSetter, size_t, double>> perClass;   // applied last
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        auto eq = line.find('=');
+        if (eq == std::string::npos) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": expected key = value");
+        }
+        std::string key = trim(line.substr(0, eq));
+        std::string val = trim(line.substr(eq + 1));
+
+        if (key == "name") { p.name = val; continue; }
+
+        const size_t dot = key.find('.');
+        if (dot != std::string::npos) {
+            auto cls = parsePlatform(std::string_view(key).substr(0, dot));
+            auto cit = classSetters().find(key.substr(dot + 1));
+            if (!cls || cit == classSetters().end()) {
+                throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": unknown key " + key);
+            }
+            if (!isNumeric(val)) {
+                throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": bad value for " + key);
+            }
+            perClass.emplace_back(cit->second, static_cast<size_t>(*cls), std::stod(val));
+            continue;
+        }
+
+        auto it = setters().find(key);
+        if (it == setters().end()) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": unknown key " + key);
+        }
+        if (!isNumeric(val)) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": bad value for " + key);
+        }
+        it->second(p, std::stod(val));
+    }
+    // After the plain keys, so an override wins wherever it appears
+    for (const auto& [set, cls, v] : perClass) set(p, cls, v);
+    return p;
+}
+
+// -------------------- ProfileCell --------------------
+static std::unique_ptr<Profile> versioned(Profile p, uint64_t version) {
+    p.version = version;
+    return std::make_unique<Profile>(std::move(p));
+}
+
+// nextVersion_ is declared before cell_, so it is ready here
+ProfileCell::ProfileCell(Profile initial)
+    : cell_(versioned(std::move(initial), nextVersion_++)) {}
+
+uint64_t ProfileCell::publish(Profile p) {
+    const uint64_t v = nextVersion_++;
+    cell_.publish(versioned(std::move(p), v));
+    return v;
+}
+
+// -------------------- ProfileWatcher --------------------
+ProfileWatcher::ProfileWatcher(std::string path, ProfileCell& cell,
+                               std::chrono::milliseconds interval)
+    : path_(std::move(path)), cell_(cell), interval_(interval) {
+    thread_ = std::thread([this]{ run(); });
+}
+
+ProfileWatcher::~ProfileWatcher() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+void ProfileWatcher::run() {
+    int64_t seen = mtimeNs(path_);
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(mu_);
+            if (cv_.wait_for(lk, interval_, [this]{ return stop_; })) return;
+        }
+        int64_t now = mtimeNs(path_);
+        if (now < 0 || now == seen) continue;
+        seen = now;
+        try {
+            Profile p = loadProfile(path_);
+            std::string name = p.name;
+            uint64_t v = cell_.publish(std::move(p));
+            std::cerr << "Profile reloaded: " << name << " v" << v << "\n";
+        } catch (const std::exception& e) {
+            std::cerr << "Profile reload failed, keeping current: " << e.what() << "\n";
+        }
+    }
+}
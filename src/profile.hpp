@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "epoch.hpp"
+#include "scoring.hpp"
+
+// -------------------- Scoring Profiles --------------------
+// Weights + suggestion thresholds loaded at runtime instead of compiled in.
+struct Profile {
+    std::string name = "default";
+    uint64_t version = 0;      // assigned by ProfileCell::publish
+    Weights weights;
+    Thresholds thresholds;
+};
+
+// Text format, one "key = value" per line, '#' comments. Keys are the
+// Weights / ThresholdSet member names plus "name"; keys not given keep their
+// defaults. A threshold key sets every platform class that has no built-in
+// value of its own for it, so intercept_range_km leaves the missile's 40 km
+// alone; "<class>.<key>" (missile.intercept_range_km, airliner.w_platform,
+// fighter.rcs_scale) sets one class and wins over the plain key. Throws std::runtime_error on an unknown key or bad value.
+Profile loadProfile(const std::string& path);
+
+// RCU cell holding the active profile. Readers pin once per cycle and use the
+// same profile for the whole cycle; the pin is a handful of atomics and never
+// blocks. publish() swaps the pointer and retires the previous profile to
+// the epoch domain, so it is freed only after the last cycle using it ends.
+class ProfileCell {
+public:
+    using Pin = RcuCell<Profile>::Pin;
+
+    explicit ProfileCell(Profile initial);
+
+    Pin pin() const { return cell_.pin(); }
+
+    // Install p as the active profile; returns the version it was given.
+    uint64_t publish(Profile p);
+
+private:
+    std::atomic<uint64_t> nextVersion_{1};
+    RcuCell<Profile> cell_;
+};
+
+// Polls a profile file's mtime and publishes it into a cell when it changes.
+// A file that fails to parse is reported and the active profile kept.
+class ProfileWatcher {
+public:
+    ProfileWatcher(std::string path, ProfileCell& cell,
+                   std::chrono::milliseconds interval = std::chrono::milliseconds(500));
+    ~ProfileWatcher();
+
+private:
+    void run();
+
+    std::string path_;
+    ProfileCell& cell_;
+    std::chrono::milliseconds interval_;
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::thread thread_;
+};
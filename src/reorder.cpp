@@ -0,0 +1,82 @@
+#include "reorder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+ReorderBuffer::ReorderBuffer(double lateness_s, double bucket_s, LateFn onLate)
+    : lateness_(lateness_s), bucket_s_(bucket_s > 0.0 ? bucket_s : lateness_s / 8.0),
+      onLate_(std::move(onLate)) {
+    if (lateness_ <= 0.0 || bucket_s_ <= 0.0) {
+        throw std::invalid_argument("Reorder lateness and bucket width must be positive");
+    }
+    // Buffered buckets span [bucketOf(newest - lateness), bucketOf(newest)]
+    ring_.resize(static_cast<size_t>(std::ceil(lateness_ / bucket_s_)) + 2);
+}
+
+int64_t ReorderBuffer::bucketOf(double t) const {
+    return static_cast<int64_t>(std::floor(t / bucket_s_));
+}
+
+ReorderBuffer::Bucket& ReorderBuffer::slot(int64_t bucket) {
+    const int64_t n = static_cast<int64_t>(ring_.size());
+    Bucket& b = ring_[static_cast<size_t>(((bucket % n) + n) % n)];
+    b.index = bucket;   // any previous occupant was released
+    return b;
+}
+
+void ReorderBuffer::push(Update u) {
+    if (!started_) {
+        started_ = true;
+        newest_ = u.t;
+        nextRelease_ = bucketOf(newest_ - lateness_);
+    }
+    if (u.t > newest_) {
+        newest_ = u.t;
+        release(bucketOf(newest_ - lateness_));
+    }
+
+    const int64_t b = bucketOf(u.t);
+    if (b < nextRelease_) {
+        ++stats_.late;
+        if (onLate_) onLate_(u);
+        return;
+    }
+    slot(b).items.emplace_back(newest_, std::move(u));
+    ++stats_.accepted;
+    stats_.peakBuffered = std::max(stats_.peakBuffered, ++buffered_);
+}
+
+void ReorderBuffer::release(int64_t upTo) {
+    if (upTo <= nextRelease_) return;
+    // Only the ring's worth of buckets after nextRelease_ can hold anything
+    const int64_t last = std::min(upTo, nextRelease_ + static_cast<int64_t>(ring_.size()));
+    const int64_t n = static_cast<int64_t>(ring_.size());
+    for (int64_t b = nextRelease_; b < last; ++b) {
+        Bucket& k = ring_[static_cast<size_t>(((b % n) + n) % n)];
+        if (k.index != b || k.items.empty()) continue;
+        std::stable_sort(k.items.begin(), k.items.end(),
+                         [](const auto& x, const auto& y) { return x.second.t < y.second.t; });
+        for (auto& [arrival, u] : k.items) {
+            const double added = newest_ - arrival;
+            stats_.latencySum += added;
+            stats_.latencyMax = std::max(stats_.latencyMax, added);
+            ready_.push_back(std::move(u));
+        }
+        stats_.released += k.items.size();
+        buffered_ -= k.items.size();
+        k.items.clear();
+    }
+    nextRelease_ = upTo;
+}
+
+bool ReorderBuffer::pop(Update& u) {
+    if (ready_.empty()) return false;
+    u = std::move(ready_.front());
+    ready_.pop_front();
+    return true;
+}
+
+void ReorderBuffer::flush() {
+    if (started_) release(bucketOf(newest_) + 1);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "stream.hpp"
+
+// -------------------- Reorder Buffer --------------------
+// Puts a live feed back in time order, waiting at most `lateness` seconds of
+// stream time for stragglers. The watermark trails the newest update seen by
+// the lateness bound; updates are held in time buckets and a bucket is
+// released, sorted, once the watermark passes its end. An update older than
+// everything already released is late: it is counted and handed to the late
+// handler (side channel) if one is set, otherwise dropped.
+struct ReorderStats {
+    size_t accepted = 0;
+    size_t released = 0;
+    size_t late = 0;
+    size_t peakBuffered = 0;
+    double latencySum = 0.0;     // stream seconds between arrival and release
+    double latencyMax = 0.0;
+
+    double meanLatency() const { return released ? latencySum / released : 0.0; }
+};
+
+class ReorderBuffer {
+public:
+    using LateFn = std::function<void(const Update&)>;
+
+    // bucket_s <= 0 picks lateness / 8.
+    explicit ReorderBuffer(double lateness_s, double bucket_s = 0.0, LateFn onLate = nullptr);
+
+    void push(Update u);
+
+    // Next released update, in time order; false when none is ready.
+    bool pop(Update& u);
+
+    // End of stream: release everything still buffered.
+    void flush();
+
+    const ReorderStats& stats() const { return stats_; }
+
+private:
+    struct Bucket {
+        int64_t index = INT64_MIN;
+        std::vector<std::pair<double, Update>> items;   // (newest seen at arrival, update)
+    };
+
+    int64_t bucketOf(double t) const;
+    Bucket& slot(int64_t bucket);
+    void release(int64_t upTo);   // buckets with index < upTo
+
+    double lateness_;
+    double bucket_s_;
+    LateFn onLate_;
+
+    std::vector<Bucket> ring_;
+    int64_t nextRelease_ = INT64_MIN;   // first bucket not yet released
+    double newest_ = 0.0;
+    bool started_ = false;
+    size_t buffered_ = 0;
+
+    std::deque<Update> ready_;
+    ReorderStats stats_;
+};
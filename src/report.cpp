@@ -0,0 +1,79 @@
+#include "report.hpp"
+
+#include <iomanip>
+#include <iostream>
+
+void printTable(const std::vector<std::pair<Contact, double>>& ranked,
+                size_t limit, const std::vector<std::string>* assetCol,
+                const Thresholds& thr) {
+    const int assetW = assetCol ? 10 : 0;
+    std::cout << std::left
+              << std::setw(10) << "RANK"
+              << std::setw(12) << "ID"
+              << std::setw(16) << "IFF"
+              << std::setw(14) << "CLASS"
+              << std::setw(12) << "RANGE(km)"
+              << std::setw(14) << "CLOSING(m/s)"
+              << std::setw(12) << "ALT(m)"
+              << std::setw(10) << "RCS(m^2)"
+              << std::setw(12) << "SCORE"
+              << std::setw(assetW) << (assetCol ? "ASSET" : "")
+              << "SUGGESTION"
+              << "\n";
+
+    std::cout << std::string(10+12+16+14+12+14+12+10+12+assetW+11, '-') << "\n";
+
+    int rank = 1;
+    for (const auto& [c, s] : ranked) {
+        if (static_cast<size_t>(rank) > limit) break;
+        const std::string asset = assetCol ? (*assetCol)[rank - 1] : "";
+        std::cout << std::left
+                  << std::setw(10) << rank++
+                  << std::setw(12) << c.id
+                  << std::setw(16) << iffToStr(c.iff)
+                  << std::setw(14) << platformToStr(c.platform)
+                  << std::setw(12) << std::fixed << std::setprecision(1) << c.range_km
+                  << std::setw(14) << std::fixed << std::setprecision(0) << c.closing_mps
+                  << std::setw(12) << std::fixed << std::setprecision(0) << c.altitude_m
+                  << std::setw(10) << std::fixed << std::setprecision(2) << c.rcs_m2
+                  << std::setw(12) << std::fixed << std::setprecision(1) << s
+                  << std::setw(assetW) << asset
+                  << suggestion(c, s, thr)
+                  << "\n";
+    }
+}
+
+void printTrackSummaries(const std::vector<TrackSummary>& rows, size_t limit) {
+    std::cout << std::left
+              << std::setw(12) << "ID"
+              << std::setw(16) << "IFF"
+              << std::setw(12) << "FIRST(s)"
+              << std::setw(12) << "LAST(s)"
+              << std::setw(10) << "UPDATES"
+              << std::setw(12) << "MIN RNG(km)"
+              << std::setw(12) << "MAX SCORE"
+              << std::setw(12) << "INTERCEPT"
+              << std::setw(12) << "ELEVATED"
+              << std::setw(12) << "MONITOR"
+              << "FRIEND"
+              << "\n";
+
+    std::cout << std::string(12+16+12+12+10+12+12+12+12+12+6, '-') << "\n";
+
+    for (size_t i = 0; i < rows.size() && i < limit; ++i) {
+        const TrackSummary& r = rows[i];
+        std::cout << std::left << std::fixed << std::setprecision(1)
+                  << std::setw(12) << r.id
+                  << std::setw(16) << iffToStr(r.iff)
+                  << std::setw(12) << r.first_seen
+                  << std::setw(12) << r.last_seen
+                  << std::setw(10) << r.updates
+                  << std::setw(12) << r.min_range_km
+                  << std::setw(12) << r.max_score
+                  << std::setw(12) << r.dwell_s[size_t(Suggestion::Intercept)]
+                  << std::setw(12) << r.dwell_s[size_t(Suggestion::Elevated)]
+                  << std::setw(12) << r.dwell_s[size_t(Suggestion::Monitor)]
+                  << r.dwell_s[size_t(Suggestion::IgnoreFriend)]
+                  << "\n";
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "contact.hpp"
+#include "scoring.hpp"
+#include "track_summary.hpp"
+
+// -------------------- Output --------------------
+// Ranked table for the operator. assetCol, when given, adds an ASSET column
+// (one entry per ranked row).
+void printTable(const std::vector<std::pair<Contact, double>>& ranked,
+                size_t limit = std::numeric_limits<size_t>::max(),
+                const std::vector<std::string>* assetCol = nullptr,
+                const Thresholds& thr = Thresholds{});
+
+// Per-track history summaries; dwell columns are seconds in each suggestion.
+void printTrackSummaries(const std::vector<TrackSummary>& rows,
+                         size_t limit = std::numeric_limits<size_t>::max());
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "contact.hpp"
+
+// -------------------- Scoring --------------------
+// Simple, explainable weighting function.
+// Larger score => higher priority.
+struct Weights {
+    double w_range_inv   = 60.0;   // closer = higher risk
+    double w_closing     = 0.25;   // approaching faster = higher risk
+    double w_rcs         = 0.4;    // bigger target = higher risk (proxy for aircraft size)
+    double w_alt_low     = 0.004;  // lower altitude slightly more concerning
+
+    // By IFF value: friends are penalized, hostiles boosted, the
+    // undetermined mildly boosted; exercise tracks score like what they play
+    double w_iff[kIffs] = {
+        -40.0,   // Friend
+         30.0,   // Foe
+         15.0,   // Unknown
+         15.0,   // Pending
+        -25.0,   // AssumedFriend
+        -10.0,   // Neutral
+         22.0,   // Suspect
+         22.0,   // Joker
+         30.0,   // Faker
+    };
+
+    // By platform class: added to the score, and a factor on the RCS term.
+    // RCS stands in for what the contact is only while that is unknown, so
+    // classified tracks lean on it less; a missile's small echo says
+    // nothing about its threat.
+    double w_platform[kPlatforms] = {
+          0.0,   // Unclassified
+         15.0,   // Fighter
+         20.0,   // Bomber
+          8.0,   // Uav
+         40.0,   // Missile
+          5.0,   // Helicopter
+        -20.0,   // Airliner
+    };
+    double rcs_scale[kPlatforms] = { 1.0, 0.5, 0.5, 0.5, 0.0, 0.5, 0.5 };
+};
+
+// Normalize helpers (to keep scores bounded-ish)
+inline double clamp(double x, double lo, double hi) {
+    return std::max(lo, std::min(hi, x));
+}
+
+// Weight-independent terms of score(). Computing these once lets several
+// Weights (production and a shadow candidate, say) share the expensive part
+// (the log10, clamps and divide) and differ only in a dot product.
+struct ScoreFeatures {
+    double inv_range;   // 1/range, capped when very close
+    double closing;     // closing speed mapped to 0..100
+    double rcs;         // log RCS mapped to 0..100-ish
+    double alt;         // low-altitude term, 0..100
+    IFF iff;
+    Platform platform;
+};
+
+inline double invRange(double range_km) {
+    // 1/range term (avoid div-by-zero)
+    return (range_km > 0.05) ? (1.0 / range_km) : 20.0; // cap when very close
+}
+
+inline ScoreFeatures scoreFeatures(double range_km, IFF iff, double closing_mps,
+                                   double altitude_m, double rcs_m2, Platform platform) {
+    ScoreFeatures f;
+    f.inv_range = invRange(range_km);
+
+    // Closing speed: positive = approaching. Scale ~0..400 m/s
+    double closing_norm = clamp(closing_mps / 400.0, 0.0, 1.0);
+    f.closing = closing_norm * 100.0; // weighted into ~0..25
+
+    // RCS: log-scale to compress (0.01..100 m^2 -> -2..2)
+    double rcs_log = std::log10(std::max(0.01, rcs_m2));
+    f.rcs = (rcs_log + 2.0) * 25.0; // map -2..2 -> 0..100-ish then weight
+
+    // Altitude: slightly prefer lower altitude (easier/closer to impact ground)
+    f.alt = (20000.0 - clamp(altitude_m, 0.0, 20000.0)) / 200.0; // 0..100
+
+    f.iff = iff;
+    f.platform = platform;
+    return f;
+}
+
+// A table load, so the batch scoring loops stay branch-free
+inline double iffWeight(IFF iff, const Weights& w) {
+    return w.w_iff[static_cast<size_t>(iff)];
+}
+
+// Likewise for the platform class terms
+inline double platformWeight(Platform p, const Weights& w) {
+    return w.w_platform[static_cast<size_t>(p)];
+}
+
+inline double rcsWeight(Platform p, const Weights& w) {
+    return w.w_rcs * w.rcs_scale[static_cast<size_t>(p)];
+}
+
+// Range term on its own, so callers that score one track against several
+// reference points can reuse everything else.
+inline double rangeTerm(double range_km, const Weights& w) {
+    return w.w_range_inv * invRange(range_km);
+}
+
+// Everything in the score except the range term.
+inline double baseFromFeatures(const ScoreFeatures& f, const Weights& w) {
+    return w.w_closing * f.closing + rcsWeight(f.platform, w) * f.rcs + w.w_alt_low * f.alt +
+           iffWeight(f.iff, w) + platformWeight(f.platform, w);
+}
+
+inline double scoreFromFeatures(const ScoreFeatures& f, const Weights& w) {
+    return w.w_range_inv * f.inv_range + baseFromFeatures(f, w);
+}
+
+// Everything in score() that does not depend on range. Takes the raw fields
+// so column stores can call it without materializing a Contact.
+inline double scoreBase(IFF iff, double closing_mps, double altitude_m, double rcs_m2,
+                        Platform platform, const Weights& w) {
+    return baseFromFeatures(scoreFeatures(0.0, iff, closing_mps, altitude_m, rcs_m2, platform), w);
+}
+
+// Contacts are scored on height above the terrain (terrain_m is 0 without
+// elevation data, leaving the reported altitude)
+inline double scoreBase(const Contact& c, const Weights& w) {
+    return scoreBase(c.iff, c.closing_mps, c.altitude_m - c.terrain_m, c.rcs_m2, c.platform, w);
+}
+
+inline double score(const Contact& c, const Weights& w) {
+    return scoreFromFeatures(
+        scoreFeatures(c.range_km, c.iff, c.closing_mps, c.altitude_m - c.terrain_m, c.rcs_m2, c.platform), w);
+}
+
+// -------------------- Engagement Suggestion --------------------
+// Very naive thresholds—tune freely (or load a profile)
+struct ThresholdSet {
+    double intercept_score       = 120.0;
+    double intercept_range_km    = 25.0;
+    double intercept_closing_mps = 100.0;
+    double elevated_score        = 80.0;
+    double elevated_range_km     = 50.0;
+};
+
+// One set per platform class, picked by a table load. A missile covers the
+// default intercept range in well under a minute, so it is flagged further
+// out.
+struct Thresholds {
+    ThresholdSet byPlatform[kPlatforms] = {
+        {}, {}, {}, {},
+        { 120.0, 40.0, 100.0, 80.0, 80.0 },   // Missile
+        {}, {},
+    };
+
+    const ThresholdSet& operator[](Platform p) const { return byPlatform[static_cast<size_t>(p)]; }
+};
+
+// Suggestion levels in increasing order of urgency (Friend aside)
+enum class Suggestion : uint8_t { IgnoreFriend, Monitor, Elevated, Intercept };
+constexpr size_t kSuggestions = 4;
+
+inline Suggestion suggestionLevel(IFF iff, Platform platform, double range_km, double closing_mps,
+                                  double riskScore, const Thresholds& thr = Thresholds{}) {
+    if (iffSide(iff) == IffSide::Friendly) return Suggestion::IgnoreFriend;   // assumed friends too
+    const ThresholdSet& t = thr[platform];
+    if (riskScore > t.intercept_score && range_km < t.intercept_range_km &&
+        closing_mps > t.intercept_closing_mps) return Suggestion::Intercept;
+    if (riskScore > t.elevated_score && range_km < t.elevated_range_km) return Suggestion::Elevated;
+    return Suggestion::Monitor;
+}
+
+inline const char* suggestionName(Suggestion s) {
+    switch (s) {
+        case Suggestion::IgnoreFriend: return "IGNORE (FRIEND)";
+        case Suggestion::Monitor:      return "MONITOR";
+        case Suggestion::Elevated:     return "ELEVATED MONITOR";
+        case Suggestion::Intercept:    return "INTERCEPT";
+    }
+    return "MONITOR";
+}
+
+inline std::string suggestion(const Contact& c, double riskScore,
+                              const Thresholds& t = Thresholds{}) {
+    return suggestionName(suggestionLevel(c.iff, c.platform, c.range_km, c.closing_mps, riskScore, t));
+}
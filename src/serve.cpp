@@ -0,0 +1,439 @@
+#include "serve.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "association.hpp"
+#include "dedup.hpp"
+#include "geodesy.hpp"
+#include "grouping.hpp"
+#include "hugepages.hpp"
+#include "profile.hpp"
+#include "reorder.hpp"
+#include "report.hpp"
+#include "shadow.hpp"
+#include "snapshot.hpp"
+#include "stream.hpp"
+#include "subscriptions.hpp"
+#include "terrain.hpp"
+#include "track_filter.hpp"
+#include "track_store.hpp"
+#include "window.hpp"
+
+namespace {
+
+struct ServeOptions {
+    std::vector<std::string> inputs;       // merged by time; stdin if none
+    size_t readAhead = 1024;               // updates buffered per feed
+    double lateness_s = 0.0;               // reorder bound; 0 = apply as read
+    std::string lateOut;                   // late updates go here, else dropped
+    double period_s = 1.0;                 // cycle length in stream time
+    std::vector<std::string> subscribe;    // view specs
+    size_t top = std::numeric_limits<size_t>::max();
+    std::string profile;                   // hot-reloaded if set
+    int reload_ms = 500;                   // 0 disables watching
+    std::string shadow;                    // candidate profile, if any
+    std::string exportPath;                // snapshot exporter output
+    bool hugepages = false;                // huge-page backed columns
+    std::vector<std::string> windows;      // window specs
+    size_t windowTop = 10;
+    std::string filter;                    // ab|kalman smoothing, off if empty
+    AssocParams assoc;                     // anonymous plot gating
+    bool dedup = false;                    // merge one aircraft's ids before ranking
+    size_t groupTop = 0;                   // groups shown per change; 0 = no grouping
+    std::string origin;                    // lat,lon[,alt]: positions are geodetic
+    std::string dem;                       // SRTM tile directory; needs an origin
+    std::string calibration;               // per-feed bias corrections
+};
+
+void usage() {
+    std::cerr << "usage: sentinelscore serve [updates.csv|-]... [--period S] [--read-ahead N]\n"
+                 "                           [--lateness S [--late-out FILE]]\n"
+                 "                           [--subscribe topk:K|above:SCORE|ids:A;B]... [--top K]\n"
+                 "                           [--profile FILE [--reload-ms MS]] [--shadow FILE]\n"
+                 "                           [--export FILE] [--hugepages] [--filter ab|kalman]\n"
+                 "                           [--gate KM] [--gate-alt M] [--dedup] [--groups K]\n"
+                 "                           [--origin LAT,LON[,ALT_M] [--dem DIR]] [--calibration FILE]\n"
+                 "                           [--window sliding|tumbling:S[:max|mean]]... [--window-top K]\n";
+}
+
+bool parseOptions(int argc, char** argv, ServeOptions& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--period" && i + 1 < argc) {
+            o.period_s = std::stod(argv[++i]);
+        } else if (arg == "--subscribe" && i + 1 < argc) {
+            o.subscribe.push_back(argv[++i]);
+        } else if (arg == "--profile" && i + 1 < argc) {
+            o.profile = argv[++i];
+        } else if (arg == "--export" && i + 1 < argc) {
+            o.exportPath = argv[++i];
+        } else if (arg == "--read-ahead" && i + 1 < argc) {
+            o.readAhead = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--lateness" && i + 1 < argc) {
+            o.lateness_s = std::stod(argv[++i]);
+        } else if (arg == "--late-out" && i + 1 < argc) {
+            o.lateOut = argv[++i];
+        } else if (arg == "--window" && i + 1 < argc) {
+            o.windows.push_back(argv[++i]);
+        } else if (arg == "--window-top" && i + 1 < argc) {
+            o.windowTop = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--gate" && i + 1 < argc) {
+            o.assoc.gate_km = std::stod(argv[++i]);
+        } else if (arg == "--gate-alt" && i + 1 < argc) {
+            o.assoc.gate_alt_m = std::stod(argv[++i]);
+        } else if (arg == "--filter" && i + 1 < argc) {
+            o.filter = argv[++i];
+        } else if (arg == "--origin" && i + 1 < argc) {
+            o.origin = argv[++i];
+        } else if (arg == "--calibration" && i + 1 < argc) {
+            o.calibration = argv[++i];
+        } else if (arg == "--dem" && i + 1 < argc) {
+            o.dem = argv[++i];
+        } else if (arg == "--groups" && i + 1 < argc) {
+            o.groupTop = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--dedup") {
+            o.dedup = true;
+        } else if (arg == "--hugepages") {
+            o.hugepages = true;
+        } else if (arg == "--shadow" && i + 1 < argc) {
+            o.shadow = argv[++i];
+        } else if (arg == "--reload-ms" && i + 1 < argc) {
+            o.reload_ms = std::stoi(argv[++i]);
+        } else if (arg == "--top" && i + 1 < argc) {
+            o.top = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "-h" || arg == "--help") {
+            return false;
+        } else if (arg == "-" || (!arg.empty() && arg[0] != '-')) {
+            o.inputs.push_back(arg);
+        } else {
+            return false;
+        }
+    }
+    return o.period_s > 0.0 && o.assoc.gate_km > 0.0 && o.assoc.gate_alt_m > 0.0 &&
+           (o.dem.empty() || !o.origin.empty());
+}
+
+void printNotification(const Notification& n) {
+    std::cout << "[cycle " << n.cycle << " t=" << std::fixed << std::setprecision(1) << n.time
+              << "] " << n.view->key();
+    for (const auto& id : n.entered) std::cout << " +" << id;
+    for (const auto& id : n.left) std::cout << " -" << id;
+    std::cout << " |";
+    for (const auto& e : *n.result) {
+        std::cout << " " << e.rank << "." << e.id;
+        if (!e.via.empty()) std::cout << "=" << e.via;
+        std::cout << "(" << e.suggestion << ")";
+    }
+    std::cout << "\n";
+}
+
+void printWindow(const WindowedTopK& w, const WindowResult& r, const TrackStore& store) {
+    std::cout << "[window " << w.spec().key() << " " << std::fixed << std::setprecision(1)
+              << r.start << "-" << r.end << "]";
+    for (size_t i = 0; i < r.top.size(); ++i) {
+        std::cout << " " << i + 1 << "." << store.id[r.top[i].track] << "(" << r.top[i].value << ")";
+    }
+    std::cout << "\n";
+}
+
+// Top groups: lead (best-scoring member), size, max and mean score, members
+void printGroups(uint64_t cycle, double t, const std::vector<TrackGroup>& groups, size_t k,
+                 const TrackStore& store) {
+    std::cout << "[groups cycle " << cycle << " t=" << std::fixed << std::setprecision(1) << t << "]";
+    for (size_t i = 0; i < groups.size() && i < k; ++i) {
+        const TrackGroup& g = groups[i];
+        std::cout << " " << i + 1 << "." << store.id[g.members.front()] << "(n=" << g.members.size()
+                  << " max=" << g.max_score << " mean=" << g.mean_score << " ";
+        for (size_t m = 0; m < g.members.size(); ++m) std::cout << (m ? ";" : "") << store.id[g.members[m]];
+        std::cout << ")";
+    }
+    std::cout << "\n";
+}
+
+} // namespace
+
+int runServe(int argc, char** argv) {
+    ServeOptions opt;
+    if (!parseOptions(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+    if (opt.hugepages) setHugePages(HugePages::On);
+
+    ProfileCell profiles(opt.profile.empty() ? Profile{} : loadProfile(opt.profile));
+    std::unique_ptr<ProfileWatcher> watcher;
+    if (!opt.profile.empty() && opt.reload_ms > 0) {
+        watcher = std::make_unique<ProfileWatcher>(opt.profile, profiles,
+                                                   std::chrono::milliseconds(opt.reload_ms));
+    }
+
+    std::unique_ptr<ShadowScorer> shadow;
+    if (!opt.shadow.empty()) shadow = std::make_unique<ShadowScorer>(loadProfile(opt.shadow));
+
+    // With an origin the feeds' position columns are latitude and
+    // longitude; each cycle converts them and replaces range_km
+    std::unique_ptr<LocalFrame> frame;
+    if (!opt.origin.empty()) frame = std::make_unique<LocalFrame>(LocalFrame::parse(opt.origin));
+    std::unique_ptr<ElevationModel> dem;
+    if (!opt.dem.empty()) dem = std::make_unique<ElevationModel>(opt.dem);
+
+    TrackStore store;
+    RangeRateTracker rangeRate;
+    TrackMotion motion;
+    PlotAssociator assoc(opt.assoc);
+    AssocStats assocTotals;
+    std::unique_ptr<TrackDeduplicator> dedup;
+    if (opt.dedup) dedup = std::make_unique<TrackDeduplicator>();
+
+    // Groups print when the shown groups' membership changes
+    std::unique_ptr<TrackGrouper> grouper;
+    std::vector<std::vector<TrackHandle>> groupsShown;
+    if (opt.groupTop > 0) grouper = std::make_unique<TrackGrouper>();
+    std::unique_ptr<TrackSmoother> smoother;
+    if (!opt.filter.empty()) smoother = std::make_unique<TrackSmoother>(parseFilterKind(opt.filter));
+    SubscriptionHub hub;
+
+    // Readers only ever see published snapshots, never the live store
+    std::unique_ptr<SnapshotStore> snaps;
+    std::unique_ptr<SnapshotExporter> exporter;
+    if (!opt.exportPath.empty()) {
+        snaps = std::make_unique<SnapshotStore>();
+        exporter = std::make_unique<SnapshotExporter>(*snaps, opt.exportPath);
+    }
+    for (const auto& spec : opt.subscribe) hub.subscribe(View::parse(spec), printNotification);
+
+    // Sliding windows print when their top-K membership changes, tumbling
+    // ones as each window closes
+    std::vector<WindowedTopK> windows;
+    std::vector<std::vector<TrackHandle>> windowShown;
+    for (const auto& spec : opt.windows) windows.emplace_back(WindowSpec::parse(spec), opt.period_s, opt.windowTop);
+    windowShown.resize(windows.size());
+    auto reportWindows = [&]() {
+        for (size_t i = 0; i < windows.size(); ++i) {
+            WindowedTopK& w = windows[i];
+            if (w.spec().kind == WindowSpec::Kind::Tumbling) {
+                for (const auto& r : w.takeClosed()) printWindow(w, r, store);
+                continue;
+            }
+            WindowResult r = w.current();
+            std::vector<TrackHandle> ids;
+            for (const auto& e : r.top) ids.push_back(e.track);
+            if (ids != windowShown[i]) {
+                printWindow(w, r, store);
+                windowShown[i] = std::move(ids);
+            }
+        }
+    };
+
+    if (opt.inputs.empty()) opt.inputs.push_back("-");
+    std::unique_ptr<CalibrationTable> calibration;
+    if (!opt.calibration.empty()) {
+        calibration = std::make_unique<CalibrationTable>(CalibrationTable::load(opt.calibration));
+        for (const auto& feed : calibration->unmatched(opt.inputs)) {
+            std::cerr << "calibration: no feed named " << feed << "\n";
+        }
+        if (frame && calibration->correctsRange()) {
+            std::cerr << "calibration: range corrections are lost with --origin for updates with a "
+                         "position (their range is recomputed from it); RCS corrections still apply\n";
+        }
+    }
+    MergedUpdateReader reader(opt.inputs, opt.readAhead, calibration.get(), frame != nullptr);
+    std::vector<Update> pending;
+    int64_t cycle = std::numeric_limits<int64_t>::min();
+    uint64_t cycles = 0;
+    uint64_t scoredVersion = 0;   // profile version the store was last fully scored with
+    double lastT = 0.0;
+
+    // Updates are coalesced per cycle: all updates that land in the same
+    // period are applied as one batch, then the picture is published once.
+    // The profile is pinned for the whole cycle, so a reload takes effect
+    // at the next cycle boundary and never mid-ranking.
+    auto endCycle = [&]() {
+        if (pending.empty()) return;
+        auto prof = profiles.pin();
+        if (dem) dem->annotate(pending);
+        if (frame) frame->convert(pending);
+
+        // Anonymous plots join the batch under the id of the track they
+        // associate with; the rest wait as tentative tracks
+        if (std::any_of(pending.begin(), pending.end(), isPlot)) {
+            auto mid = std::stable_partition(pending.begin(), pending.end(),
+                                             [](const Update& u) { return !isPlot(u); });
+            std::vector<Update> plots(std::make_move_iterator(mid), std::make_move_iterator(pending.end()));
+            pending.erase(mid, pending.end());
+            AssocStats st;
+            auto named = assoc.associate(store, motion, plots, lastT, &st);
+            assocTotals += st;
+            pending.insert(pending.end(), std::make_move_iterator(named.begin()),
+                           std::make_move_iterator(named.end()));
+        }
+
+        auto prodStart = std::chrono::steady_clock::now();
+        auto touched = store.applyBatch(pending, prof->weights);   // rescores touched tracks
+        pending.clear();
+        motion.observe(store, touched);
+
+        // Range-only reports get closing speed from the track's range history
+        auto derived = rangeRate.update(store, touched);
+
+        // Smoothing replaces the touched tracks' raw range and altitude, so
+        // all of them are rescored (derived ones included)
+        if (smoother) {
+            smoother->update(store, touched);
+            store.rescore(prof->weights, touched);
+        } else if (!derived.empty()) {
+            store.rescore(prof->weights, derived);
+        }
+
+        // Untouched tracks need a full pass when the weights changed. The
+        // shadow side follows the same tracks, timed against this path.
+        const bool full = prof->version != scoredVersion;
+        if (full) store.rescore(prof->weights);
+        scoredVersion = prof->version;
+        if (shadow) {
+            shadow->update(store, touched, full,
+                           std::chrono::duration<double, std::nano>(
+                               std::chrono::steady_clock::now() - prodStart).count());
+        }
+
+        auto ranking = store.rank();
+        if (dedup) {
+            dedup->run(store, lastT);
+            dedup->filter(ranking);
+        }
+        hub.publish(cycles, lastT, store, ranking, prof->thresholds, dedup.get());
+        if (!windows.empty()) {
+            for (auto& w : windows) {
+                for (TrackHandle h : touched) w.add(h, store.last_seen[h], store.score[h]);
+                w.advance(lastT);
+            }
+            reportWindows();
+        }
+        if (grouper) {
+            grouper->run(store, motion, lastT);
+            std::vector<std::vector<TrackHandle>> shown;
+            for (size_t i = 0; i < grouper->groups().size() && i < opt.groupTop; ++i) {
+                shown.push_back(grouper->groups()[i].members);
+                std::sort(shown.back().begin(), shown.back().end());
+            }
+            if (shown != groupsShown) {
+                printGroups(cycles, lastT, grouper->groups(), opt.groupTop, store);
+                groupsShown = std::move(shown);
+            }
+        }
+        if (shadow) {
+            std::cout << "[shadow cycle " << cycles << "] "
+                      << formatShadowReport(shadow->compare(store, ranking, prof->thresholds))
+                      << "\n";
+        }
+        if (snaps) snaps->publish(store, std::move(ranking), cycles, lastT);
+        ++cycles;
+    };
+
+    auto apply = [&](Update&& u) {
+        int64_t c = static_cast<int64_t>(std::floor(u.t / opt.period_s));
+        if (c != cycle) {
+            endCycle();
+            cycle = c;
+        }
+        lastT = u.t;
+        pending.push_back(std::move(u));
+    };
+
+    // With a lateness bound, updates pass through the reorder buffer and
+    // reach the cycles in time order; too-late ones go to --late-out
+    std::unique_ptr<std::ofstream> lateOut;
+    std::unique_ptr<ReorderBuffer> reorder;
+    if (opt.lateness_s > 0.0) {
+        ReorderBuffer::LateFn onLate;
+        if (!opt.lateOut.empty()) {
+            lateOut = std::make_unique<std::ofstream>(opt.lateOut);
+            if (!*lateOut) throw std::runtime_error("Failed to create " + opt.lateOut);
+            *lateOut << std::setprecision(10);
+            onLate = [&](const Update& late) { writeUpdate(*lateOut, late); };
+        }
+        reorder = std::make_unique<ReorderBuffer>(opt.lateness_s, 0.0, std::move(onLate));
+    }
+
+    Update u;
+    while (reader.next(u)) {
+        if (!reorder) {
+            apply(std::move(u));
+            continue;
+        }
+        reorder->push(std::move(u));
+        while (reorder->pop(u)) apply(std::move(u));
+    }
+    if (reorder) {
+        reorder->flush();
+        while (reorder->pop(u)) apply(std::move(u));
+    }
+    endCycle();
+    for (auto& w : windows) w.flush();
+    reportWindows();
+    exporter.reset();   // flush the final version
+
+    if (store.size() == 0) {
+        std::cerr << "No updates read from " << opt.inputs[0]
+                  << (opt.inputs.size() > 1 ? " and the other feeds" : "") << "\n";
+        return 1;
+    }
+
+    if (opt.subscribe.empty()) {
+        std::vector<std::pair<Contact, double>> ranked;
+        Ranking order = store.rank();
+        if (dedup) dedup->filter(order);
+        for (TrackHandle h : order) ranked.emplace_back(store.contact(h), store.score[h]);
+        printTable(ranked, opt.top, nullptr, profiles.pin()->thresholds);
+    }
+    std::cerr << cycles << " cycles, " << store.size() << " tracks\n";
+    if (snaps) {
+        std::cerr << "snapshots: v" << snaps->version() << ", last publish copied "
+                  << snaps->lastCopiedChunks() << " and shared " << snaps->lastSharedChunks()
+                  << " chunks, " << (snaps->lastSharedRanking() ? "shared" : "copied") << " the ranking\n";
+    }
+    if (reorder) {
+        const ReorderStats& rs = reorder->stats();
+        std::cerr << std::fixed << std::setprecision(2) << "reorder: lateness " << opt.lateness_s
+                  << " s, " << rs.accepted << " updates reordered, " << rs.late << " late ("
+                  << (lateOut ? "written to " + opt.lateOut : std::string("dropped"))
+                  << "), added latency mean " << rs.meanLatency() << " s max " << rs.latencyMax
+                  << " s, peak buffered " << rs.peakBuffered << "\n";
+    }
+    if (dedup) {
+        std::cerr << "dedup: " << dedup->duplicates() << " duplicate tracks in " << dedup->groups()
+                  << " groups hidden from the last ranking\n";
+    }
+    if (dem) {
+        const TerrainStats& ts = dem->stats();
+        std::cerr << "terrain: " << ts.lookups << " lookups, " << ts.tileLoads << " tile loads, "
+                  << ts.missingTiles << " cells without a tile, " << ts.evictions << " evictions\n";
+    }
+    if (assocTotals.plots > 0) {
+        std::cerr << "association: " << assocTotals.plots << " plots, " << assocTotals.assigned
+                  << " to existing tracks, " << assocTotals.confirmed << " confirmed new tracks, "
+                  << assocTotals.started << " tentative starts, " << assocTotals.noPosition
+                  << " without position, " << assoc.tentative() << " tentative at end\n";
+    }
+    if (shadow) {
+        std::cerr << std::fixed << std::setprecision(3)
+                  << "shadow " << shadow->candidate().name << ": mean tau "
+                  << shadow->meanTau() << ", " << shadow->totalDisagreements()
+                  << " suggestion disagreements, overhead " << std::setprecision(1)
+                  << shadow->meanOverhead() * 100.0 << "% of production apply + scoring\n";
+    }
+    return 0;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// -------------------- Serve Mode --------------------
+// Continuous operation: consume a timestamped update stream, apply it one
+// cycle at a time to the track store, rescore, and push ranking changes to
+// subscribers. argv[0] is "serve".
+int runServe(int argc, char** argv);
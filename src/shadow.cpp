@@ -0,0 +1,160 @@
+#include "shadow.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double nsSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+// Inversions in v via merge sort, O(n log n)
+uint64_t countInversions(std::vector<size_t>& v, std::vector<size_t>& tmp, size_t lo, size_t hi) {
+    if (hi - lo < 2) return 0;
+    size_t mid = lo + (hi - lo) / 2;
+    uint64_t inv = countInversions(v, tmp, lo, mid) + countInversions(v, tmp, mid, hi);
+    size_t i = lo, j = mid, k = lo;
+    while (i < mid && j < hi) {
+        if (v[i] <= v[j]) tmp[k++] = v[i++];
+        else { tmp[k++] = v[j++]; inv += mid - i; }
+    }
+    while (i < mid) tmp[k++] = v[i++];
+    while (j < hi) tmp[k++] = v[j++];
+    std::copy(tmp.begin() + lo, tmp.begin() + hi, v.begin() + lo);
+    return inv;
+}
+
+} // namespace
+
+ShadowScorer::ShadowScorer(Profile candidate, size_t topK)
+    : cand_(std::move(candidate)), topK_(topK) {}
+
+void ShadowScorer::rescore(TrackStore& store, const Weights& production) {
+    auto t0 = Clock::now();
+    store.rescore(production);
+    update(store, {}, true, nsSince(t0));
+}
+
+void ShadowScorer::update(const TrackStore& store, const std::vector<TrackHandle>& touched,
+                          bool full, double prodNs) {
+    const size_t n = store.size();
+    invRange_.resize(n);
+    closing_.resize(n);
+    rcs_.resize(n);
+    alt_.resize(n);
+    iff_.resize(n);
+    platform_.resize(n);
+    score_.resize(n);
+    lastProdNs_ = prodNs;
+
+    // New tracks are always among the touched ones, so outside a full pass
+    // every other cache entry is still current
+    const bool all = full || !primed_;
+    primed_ = true;
+    auto each = [&](auto fn) {
+        if (all) {
+            for (TrackHandle h = 0; h < n; ++h) fn(h);
+        } else {
+            for (TrackHandle h : touched) fn(h);
+        }
+    };
+
+    auto t1 = Clock::now();
+    each([&](TrackHandle h) {
+        ScoreFeatures f = store.features(h);
+        invRange_[h] = f.inv_range;
+        closing_[h]  = f.closing;
+        rcs_[h]      = f.rcs;
+        alt_[h]      = f.alt;
+        iff_[h]      = f.iff;
+        platform_[h] = f.platform;
+    });
+    lastCacheNs_ = nsSince(t1);
+
+    auto t2 = Clock::now();
+    const Weights& w = cand_.weights;
+    each([&](TrackHandle h) {
+        score_[h] = w.w_range_inv * invRange_[h] + w.w_closing * closing_[h]
+                  + rcsWeight(platform_[h], w) * rcs_[h] + w.w_alt_low * alt_[h]
+                  + iffWeight(iff_[h], w) + platformWeight(platform_[h], w);
+    });
+    lastCandNs_ = nsSince(t2);
+}
+
+ShadowReport ShadowScorer::compare(const TrackStore& store,
+                                   const Ranking& prodRanking,
+                                   const Thresholds& prodThr) {
+    auto t0 = Clock::now();
+    ShadowReport r;
+    const size_t n = prodRanking.size();
+    r.tracks = n;
+
+    Ranking candRanking(prodRanking);
+    std::sort(candRanking.begin(), candRanking.end(), [this](TrackHandle a, TrackHandle b) {
+        return score_[a] != score_[b] ? score_[a] > score_[b] : a < b;
+    });
+
+    std::vector<size_t> candRankOf(store.size());
+    for (size_t i = 0; i < n; ++i) candRankOf[candRanking[i]] = i;
+
+    // Candidate rank of each track, in production order
+    std::vector<size_t> seq(n), tmp(n);
+    for (size_t i = 0; i < n; ++i) {
+        seq[i] = candRankOf[prodRanking[i]];
+        size_t shift = seq[i] > i ? seq[i] - i : i - seq[i];
+        r.max_rank_shift = std::max(r.max_rank_shift, shift);
+    }
+    if (n >= 2) {
+        uint64_t inv = countInversions(seq, tmp, 0, n);
+        r.kendall_tau = 1.0 - 4.0 * static_cast<double>(inv) / (static_cast<double>(n) * (n - 1));
+    }
+
+    r.top_k = std::min(topK_, n);
+    if (r.top_k > 0) {
+        size_t both = 0;
+        for (size_t i = 0; i < r.top_k; ++i) both += candRankOf[prodRanking[i]] < r.top_k;
+        r.top_k_overlap = static_cast<double>(both) / r.top_k;
+    }
+
+    for (TrackHandle h : prodRanking) {
+        Contact c = store.contact(h);
+        std::string p = suggestion(c, store.score[h], prodThr);
+        std::string s = suggestion(c, score_[h], cand_.thresholds);
+        if (p == s) continue;
+        ++r.disagreements;
+        if (r.examples.size() < 3) r.examples.push_back(c.id + " " + p + "->" + s);
+    }
+
+    r.prod_ns = lastProdNs_;
+    r.cache_ns = lastCacheNs_;
+    r.cand_ns = lastCandNs_;
+    r.compare_ns = nsSince(t0);
+
+    ++cycles_;
+    totalDisagreements_ += r.disagreements;
+    sumTau_ += r.kendall_tau;
+    totalProdNs_ += r.prod_ns;
+    totalShadowNs_ += r.cache_ns + r.cand_ns + r.compare_ns;
+    return r;
+}
+
+std::string formatShadowReport(const ShadowReport& r) {
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(3)
+       << "tau=" << r.kendall_tau
+       << " top" << r.top_k << "=" << r.top_k_overlap
+       << " maxshift=" << r.max_rank_shift
+       << " disagree=" << r.disagreements;
+    for (const auto& e : r.examples) os << " [" << e << "]";
+    os << std::setprecision(1)
+       << " prod=" << r.prod_ns / 1000.0 << "us cache=" << r.cache_ns / 1000.0
+       << "us cand=" << r.cand_ns / 1000.0
+       << "us cmp=" << r.compare_ns / 1000.0 << "us"
+       << " (+" << r.overhead() * 100.0 << "%)";
+    return os.str();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "profile.hpp"
+#include "track_store.hpp"
+
+// -------------------- Shadow Scoring --------------------
+// Scores a candidate profile alongside production on the same picture.
+// Production scores exactly as it would alone (in serve, only the tracks a
+// cycle touched). The shadow side keeps the weight-independent features of
+// every track in a cache and refreshes only the touched tracks, so the
+// candidate costs a dot product per touched track. Every phase is timed,
+// and the overhead is measured against the production path it rides on.
+struct ShadowReport {
+    size_t tracks = 0;
+    double kendall_tau = 1.0;       // rank correlation, 1 = identical order
+    size_t top_k = 0;               // K used for the overlap below
+    double top_k_overlap = 1.0;     // |prod top-K ∩ cand top-K| / K
+    size_t max_rank_shift = 0;      // largest |prod rank - cand rank|
+    size_t disagreements = 0;       // tracks whose suggestion() differs
+    std::vector<std::string> examples;   // a few "ID PROD->CAND" strings
+    double prod_ns = 0.0;           // production apply + scoring this cycle
+    double cache_ns = 0.0;          // filling the feature cache
+    double cand_ns = 0.0;           // candidate scores from cached features
+    double compare_ns = 0.0;        // ranking + suggestion comparison
+
+    // Extra work relative to production scoring alone
+    double overhead() const { return prod_ns > 0.0 ? (cache_ns + cand_ns + compare_ns) / prod_ns : 0.0; }
+};
+
+class ShadowScorer {
+public:
+    explicit ShadowScorer(Profile candidate, size_t topK = 10);
+
+    const Profile& candidate() const { return cand_; }
+
+    // Full production sweep (TrackStore::rescore), then a full update().
+    void rescore(TrackStore& store, const Weights& production);
+
+    // After production has scored the cycle (taking prodNs): refresh the
+    // cache and candidate scores for the touched tracks, or for every track
+    // when full is set (the production profile changed) or on first use.
+    void update(const TrackStore& store, const std::vector<TrackHandle>& touched, bool full,
+                double prodNs);
+
+    // Compare this cycle's rankings and suggestions.
+    ShadowReport compare(const TrackStore& store, const Ranking& prodRanking,
+                         const Thresholds& prodThr);
+
+    const HugeVector<double>& scores() const { return score_; }
+
+    // Running totals across compare() calls
+    uint64_t cycles() const { return cycles_; }
+    uint64_t totalDisagreements() const { return totalDisagreements_; }
+    double meanTau() const { return cycles_ ? sumTau_ / cycles_ : 1.0; }
+    double meanOverhead() const { return totalProdNs_ > 0 ? totalShadowNs_ / totalProdNs_ : 0.0; }
+
+private:
+    Profile cand_;
+    size_t topK_;
+
+    // Cached per-track features (SoA) shared by both scorers
+    HugeVector<double> invRange_, closing_, rcs_, alt_;
+    HugeVector<IFF> iff_;
+    HugeVector<Platform> platform_;
+    HugeVector<double> score_;
+    double lastProdNs_ = 0.0;
+    double lastCacheNs_ = 0.0;
+    double lastCandNs_ = 0.0;
+    bool primed_ = false;           // cache filled for every track once
+
+    uint64_t cycles_ = 0;
+    uint64_t totalDisagreements_ = 0;
+    double sumTau_ = 0.0;
+    double totalProdNs_ = 0.0;
+    double totalShadowNs_ = 0.0;
+};
+
+std::string formatShadowReport(const ShadowReport& r);
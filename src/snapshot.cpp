@@ -0,0 +1,144 @@
+#include "snapshot.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+Contact Snapshot::contact(TrackHandle h) const {
+    const SnapshotChunk& k = chunkOf(h);
+    const size_t r = row(h);
+    Contact c { k.id[r], k.iff[r], k.range_km[r], k.closing_mps[r], k.altitude_m[r], k.rcs_m2[r] };
+    c.has_closing = k.has_closing[r] != 0;
+    c.has_pos     = k.has_pos[r] != 0;
+    c.east_km     = k.east_km[r];
+    c.north_km    = k.north_km[r];
+    c.terrain_m   = k.terrain_m[r];
+    c.platform    = k.platform[r];
+    return c;
+}
+
+namespace {
+
+template <class T, class A>
+std::vector<T> slice(const std::vector<T, A>& col, size_t lo, size_t hi) {
+    return std::vector<T>(col.begin() + lo, col.begin() + hi);
+}
+
+std::shared_ptr<const SnapshotChunk> copyChunk(const TrackStore& s, size_t chunk) {
+    const size_t lo = chunk * TrackStore::kChunkRows;
+    const size_t hi = std::min(s.size(), lo + TrackStore::kChunkRows);
+    auto k = std::make_shared<SnapshotChunk>();
+    k->id          = slice(s.id, lo, hi);
+    k->iff         = slice(s.iff, lo, hi);
+    k->platform    = slice(s.platform, lo, hi);
+    k->range_km    = slice(s.range_km, lo, hi);
+    k->closing_mps = slice(s.closing_mps, lo, hi);
+    k->has_closing = slice(s.has_closing, lo, hi);
+    k->altitude_m  = slice(s.altitude_m, lo, hi);
+    k->rcs_m2      = slice(s.rcs_m2, lo, hi);
+    k->has_pos     = slice(s.has_pos, lo, hi);
+    k->east_km     = slice(s.east_km, lo, hi);
+    k->north_km    = slice(s.north_km, lo, hi);
+    k->terrain_m   = slice(s.terrain_m, lo, hi);
+    k->last_seen   = slice(s.last_seen, lo, hi);
+    k->score       = slice(s.score, lo, hi);
+    return k;
+}
+
+} // namespace
+
+SnapshotStore::SnapshotStore() : cell_(std::make_unique<Snapshot>()) {}
+
+uint64_t SnapshotStore::publish(TrackStore& store, Ranking ranking,
+                                uint64_t cycle, double time) {
+    auto snap = std::make_unique<Snapshot>();
+    snap->version = version_.load(std::memory_order_relaxed) + 1;
+    snap->cycle   = cycle;
+    snap->time    = time;
+    snap->tracks  = store.size();
+    // Comparing is a read of both orders; keeping a second copy would be an
+    // allocation and n more handles held until the version is reclaimed
+    lastRankingShared_ = lastRanking_ && *lastRanking_ == ranking;
+    if (!lastRankingShared_) lastRanking_ = std::make_shared<const Ranking>(std::move(ranking));
+    snap->ranking = lastRanking_;
+
+    const size_t n = store.chunks();
+    snap->chunks.resize(n);
+    lastCopied_ = lastShared_ = 0;
+    for (size_t c = 0; c < n; ++c) {
+        if (c < lastChunks_.size() && !store.chunkDirty(c)) {
+            snap->chunks[c] = lastChunks_[c];
+            ++lastShared_;
+        } else {
+            snap->chunks[c] = copyChunk(store, c);
+            ++lastCopied_;
+        }
+    }
+    store.clearDirty();
+    lastChunks_ = snap->chunks;
+
+    const uint64_t v = snap->version;
+    cell_.publish(std::move(snap));
+    version_.store(v, std::memory_order_release);
+    return v;
+}
+
+// -------------------- SnapshotExporter --------------------
+SnapshotExporter::SnapshotExporter(const SnapshotStore& snaps, std::string path,
+                                   std::chrono::milliseconds poll)
+    : snaps_(snaps), path_(std::move(path)), poll_(poll) {
+    thread_ = std::thread([this]{ run(); });
+}
+
+SnapshotExporter::~SnapshotExporter() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    exportLatest();
+}
+
+void SnapshotExporter::run() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(mu_);
+            if (cv_.wait_for(lk, poll_, [this]{ return stop_; })) return;
+        }
+        exportLatest();
+    }
+}
+
+void SnapshotExporter::exportLatest() {
+    if (snaps_.version() == seen_) return;
+
+    auto snap = snaps_.pin();
+    seen_ = snap->version;
+
+    const std::string tmp = path_ + ".tmp";
+    {
+        std::ofstream out(tmp);
+        if (!out) {
+            std::cerr << "Snapshot export failed: cannot write " << tmp << "\n";
+            return;
+        }
+        out << "# version " << snap->version << " cycle " << snap->cycle
+            << " time " << snap->time << "\n";
+        out << "rank,id,iff,range_km,closing_mps,altitude_m,rcs_m2,score,platform\n";
+        out << std::fixed;
+        const Ranking& ranking = *snap->ranking;
+        for (size_t i = 0; i < ranking.size(); ++i) {
+            TrackHandle h = ranking[i];
+            Contact c = snap->contact(h);
+            out << i + 1 << "," << c.id << "," << iffToStr(c.iff) << ","
+                << std::setprecision(2) << c.range_km << "," << c.closing_mps << ","
+                << c.altitude_m << "," << c.rcs_m2 << "," << std::setprecision(3)
+                << snap->score(h) << "," << platformToStr(c.platform) << "\n";
+        }
+    }
+    std::rename(tmp.c_str(), path_.c_str());
+    exported_.fetch_add(1);
+}
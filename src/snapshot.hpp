@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "epoch.hpp"
+#include "track_store.hpp"
+
+// -------------------- MVCC Snapshots --------------------
+// Immutable, versioned copies of the track picture for concurrent readers
+// (renderers, query clients, exporters). Columns are split into chunks of
+// TrackStore::kChunkRows rows; a new version copies only the chunks the
+// writer dirtied since the previous version and shares the rest, so the
+// column copies per version follow the update rate, not the picture size.
+// The ranking covers every track: a version shares the previous one's when
+// the order is unchanged, and otherwise holds a full copy of it.
+
+// One chunk's rows of every column. Never modified once published.
+struct SnapshotChunk {
+    std::vector<std::string> id;
+    std::vector<IFF>         iff;
+    std::vector<Platform>    platform;
+    std::vector<double>      range_km;
+    std::vector<double>      closing_mps;
+    std::vector<uint8_t>     has_closing;
+    std::vector<double>      altitude_m;
+    std::vector<double>      rcs_m2;
+    std::vector<uint8_t>     has_pos;
+    std::vector<double>      east_km;
+    std::vector<double>      north_km;
+    std::vector<double>      terrain_m;
+    std::vector<double>      last_seen;
+    std::vector<double>      score;
+};
+
+struct Snapshot {
+    uint64_t version = 0;
+    uint64_t cycle = 0;
+    double time = 0.0;              // stream time of the cycle
+    size_t tracks = 0;
+    std::vector<std::shared_ptr<const SnapshotChunk>> chunks;
+    std::shared_ptr<const Ranking> ranking;
+
+    const SnapshotChunk& chunkOf(TrackHandle h) const { return *chunks[h / TrackStore::kChunkRows]; }
+    static size_t row(TrackHandle h) { return h % TrackStore::kChunkRows; }
+
+    double score(TrackHandle h) const { return chunkOf(h).score[row(h)]; }
+    Contact contact(TrackHandle h) const;
+};
+
+// Single writer, any number of readers. Readers pin a version without
+// blocking the writer; the writer never waits for readers; superseded
+// versions are reclaimed through the epoch domain once the last reader
+// pinning them lets go.
+class SnapshotStore {
+public:
+    using Pin = RcuCell<Snapshot>::Pin;
+
+    SnapshotStore();
+
+    // Build and publish the next version from the store's current state,
+    // copying dirty chunks, then clear the store's dirty marks.
+    uint64_t publish(TrackStore& store, Ranking ranking,
+                     uint64_t cycle, double time);
+
+    Pin pin() const { return cell_.pin(); }
+
+    // Latest published version (0 before the first publish). Cheap enough
+    // for readers to poll.
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+    // Counters from the last publish
+    size_t lastCopiedChunks() const { return lastCopied_; }
+    size_t lastSharedChunks() const { return lastShared_; }
+    bool lastSharedRanking() const { return lastRankingShared_; }
+    size_t retiredPending() const { return cell_.pendingReclaim(); }
+
+private:
+    RcuCell<Snapshot> cell_;
+    std::atomic<uint64_t> version_{0};
+    std::vector<std::shared_ptr<const SnapshotChunk>> lastChunks_;   // writer-owned
+    std::shared_ptr<const Ranking> lastRanking_;                      // writer-owned
+    size_t lastCopied_ = 0;
+    size_t lastShared_ = 0;
+    bool lastRankingShared_ = false;
+};
+
+// Reader thread that writes the ranking of each new version it observes to
+// a CSV file (written to FILE.tmp, then renamed, so consumers never see a
+// partial file). A slow disk only makes it skip versions; the writer is
+// unaffected.
+class SnapshotExporter {
+public:
+    SnapshotExporter(const SnapshotStore& snaps, std::string path,
+                     std::chrono::milliseconds poll = std::chrono::milliseconds(50));
+    ~SnapshotExporter();   // exports the latest version once more, then stops
+
+    uint64_t exported() const { return exported_.load(); }
+
+private:
+    void run();
+    void exportLatest();
+
+    const SnapshotStore& snaps_;
+    std::string path_;
+    std::chrono::milliseconds poll_;
+    uint64_t seen_ = 0;
+    std::atomic<uint64_t> exported_{0};
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::thread thread_;
+};
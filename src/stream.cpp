@@ -0,0 +1,143 @@
+#include "stream.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "csv.hpp"
+
+void writeUpdate(std::ostream& out, const Update& u) {
+    const Contact& c = u.c;
+    out << u.t << "," << c.id << "," << iffToStr(c.iff) << "," << c.range_km << ",";
+    if (c.has_closing) out << c.closing_mps;
+    out << "," << c.altitude_m << "," << c.rcs_m2;
+    if (c.has_geo) out << "," << c.lat_deg << "," << c.lon_deg;
+    else if (c.has_pos) out << "," << c.east_km << "," << c.north_km;
+    else out << ",,";
+    out << "," << platformToStr(c.platform) << "\n";
+}
+
+UpdateReader::UpdateReader(const std::string& path, size_t bufferBytes) : path_(path) {
+    if (path == "-") {
+        in_ = &std::cin;
+        return;
+    }
+    auto file = std::make_unique<std::ifstream>();
+    if (bufferBytes > 0) {
+        buffer_.resize(bufferBytes);
+        file->rdbuf()->pubsetbuf(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    }
+    file->open(path);
+    owned_ = std::move(file);
+    if (!*owned_) {
+        throw std::runtime_error("Failed to open update stream: " + path);
+    }
+    in_ = owned_.get();
+}
+
+bool UpdateReader::next(Update& u) {
+    std::string line;
+    while (std::getline(*in_, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        auto cols = splitCSV(line);
+        if (maybeHeader_) {
+            maybeHeader_ = false;
+            // Header if the time column is not numeric
+            if (!cols.empty() && !isNumeric(cols[0])) continue;
+        }
+
+        if (cols.empty()) continue;
+        auto c = parseContact(cols, 1, line);
+        if (!c) continue;
+
+        u.t = toDouble(cols[0], 0.0);
+        u.c = std::move(*c);
+        if (geodetic_ && u.c.has_pos) {
+            u.c.has_geo = true;
+            u.c.lat_deg = u.c.east_km;
+            u.c.lon_deg = u.c.north_km;
+            u.c.has_pos = false;
+            u.c.east_km = u.c.north_km = 0.0;
+        }
+        if (calibrate_) cal_.apply(u.c);
+        return true;
+    }
+    return false;
+}
+
+// -------------------- MergedUpdateReader --------------------
+MergedUpdateReader::MergedUpdateReader(const std::vector<std::string>& paths, size_t readAhead,
+                                       const CalibrationTable* calibration, bool geodetic)
+    : readAhead_(std::max<size_t>(1, readAhead)) {
+    if (paths.empty()) throw std::runtime_error("No update feeds given");
+    feeds_.resize(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        // Roughly one batch of CSV rows per file buffer
+        feeds_[i].reader = std::make_unique<UpdateReader>(paths[i], readAhead_ * 64);
+        if (calibration) feeds_[i].reader->setCalibration(calibration->forFeed(paths[i]));
+        feeds_[i].reader->setGeodetic(geodetic);
+        feeds_[i].buf.reserve(readAhead_);
+        refill(feeds_[i]);
+    }
+    tree_.assign(feeds_.size(), 0);
+    tree_[0] = build(1);
+}
+
+void MergedUpdateReader::refill(Feed& f) {
+    f.buf.clear();
+    f.pos = 0;
+    Update u;
+    while (f.buf.size() < readAhead_ && f.reader->next(u)) {
+        if (u.t < f.lastT && !f.warned) {
+            std::cerr << "Feed " << f.reader->path() << " is not time-ordered at t=" << u.t
+                      << "; merging as is\n";
+            f.warned = true;
+        }
+        f.lastT = u.t;
+        f.buf.push_back(std::move(u));
+    }
+    f.done = f.buf.empty();
+}
+
+bool MergedUpdateReader::before(size_t a, size_t b) const {
+    const Feed& fa = feeds_[a];
+    const Feed& fb = feeds_[b];
+    if (fa.done != fb.done) return fb.done;   // exhausted feeds lose
+    if (fa.done) return a < b;
+    const double ta = fa.buf[fa.pos].t, tb = fb.buf[fb.pos].t;
+    return ta != tb ? ta < tb : a < b;
+}
+
+// Winner of the subtree at node; leaves are nodes N..2N-1
+size_t MergedUpdateReader::build(size_t node) {
+    const size_t n = feeds_.size();
+    if (node >= n) return node - n;
+    size_t a = build(2 * node), b = build(2 * node + 1);
+    if (before(a, b)) {
+        tree_[node] = b;
+        return a;
+    }
+    tree_[node] = a;
+    return b;
+}
+
+// The winner's head changed: replay its path up to the root
+void MergedUpdateReader::replay(size_t feed) {
+    for (size_t node = (feed + feeds_.size()) / 2; node > 0; node /= 2) {
+        if (before(tree_[node], feed)) std::swap(tree_[node], feed);
+    }
+    tree_[0] = feed;
+}
+
+bool MergedUpdateReader::next(Update& u) {
+    const size_t w = tree_[0];
+    Feed& f = feeds_[w];
+    if (f.done) return false;
+    u = std::move(f.buf[f.pos++]);
+    if (f.pos == f.buf.size()) refill(f);
+    replay(w);
+    return true;
+}
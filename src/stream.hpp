@@ -0,0 +1,93 @@
+#pragma once
+
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "calibration.hpp"
+#include "contact.hpp"
+
+// -------------------- Update Stream --------------------
+// Timestamped contact reports for continuous (serve) mode. CSV columns
+// (header optional):
+// time_s, id, iff, range_km, closing_mps, altitude_m, rcs_m2[, east_km, north_km[, platform]]
+// Geodetic feeds carry lat_deg, lon_deg in the position columns instead.
+struct Update {
+    double t;      // stream time (s)
+    Contact c;
+};
+
+// One update as a CSV row UpdateReader can read back (numbers use the
+// stream's current formatting). A geodetic position is written as
+// latitude/longitude, as it was read; east/north are empty without one,
+// and closing is empty if it was not reported.
+void writeUpdate(std::ostream& out, const Update& u);
+
+class UpdateReader {
+public:
+    // "-" reads from stdin. bufferBytes > 0 sets the file read buffer size.
+    explicit UpdateReader(const std::string& path, size_t bufferBytes = 0);
+
+    // Next well-formed update; false at end of stream. Comments, the
+    // header and malformed rows are skipped (malformed rows are logged).
+    bool next(Update& u);
+
+    // Correct every row from now on as it is parsed
+    void setCalibration(const Calibration& c) { cal_ = c; calibrate_ = !c.identity(); }
+
+    // Read the position columns as latitude/longitude (Contact::lat_deg,
+    // lon_deg) rather than east/north
+    void setGeodetic(bool on) { geodetic_ = on; }
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    std::unique_ptr<std::istream> owned_;
+    std::vector<char> buffer_;
+    std::istream* in_ = nullptr;
+    bool maybeHeader_ = true;
+    Calibration cal_;
+    bool calibrate_ = false;
+    bool geodetic_ = false;
+};
+
+// One time-ordered stream out of several time-sorted feeds, merged with a
+// loser tree: each update costs log2(N) comparisons against the other
+// feeds' heads. Each feed is read ahead in batches of readAhead updates, so
+// memory is bounded by N * readAhead whatever the length of the feeds.
+// Updates with equal times come out in feed order. A feed that goes
+// backwards in time is reported once and merged as it stands.
+class MergedUpdateReader {
+public:
+    // Each feed is corrected with its calibration entry, if any. geodetic
+    // feeds carry latitude/longitude (see UpdateReader::setGeodetic).
+    explicit MergedUpdateReader(const std::vector<std::string>& paths, size_t readAhead = 1024,
+                                const CalibrationTable* calibration = nullptr, bool geodetic = false);
+
+    bool next(Update& u);
+
+    size_t feeds() const { return feeds_.size(); }
+
+private:
+    struct Feed {
+        std::unique_ptr<UpdateReader> reader;
+        std::vector<Update> buf;
+        size_t pos = 0;
+        double lastT = -std::numeric_limits<double>::infinity();   // any first time is in order
+        bool done = false;
+        bool warned = false;
+    };
+
+    void refill(Feed& f);
+    bool before(size_t a, size_t b) const;   // a's head merges first
+    size_t build(size_t node);
+    void replay(size_t feed);
+
+    std::vector<Feed> feeds_;
+    std::vector<size_t> tree_;   // [0] winner, [1..N) losers of each match
+    size_t readAhead_;
+};
@@ -0,0 +1,162 @@
+#include "subscriptions.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+View View::parse(const std::string& spec) {
+    auto colon = spec.find(':');
+    if (colon == std::string::npos) {
+        throw std::invalid_argument("Bad view spec (want kind:arg): " + spec);
+    }
+    std::string kind = spec.substr(0, colon);
+    std::string arg  = spec.substr(colon + 1);
+
+    View v;
+    if (kind == "topk") {
+        v.kind = Kind::TopK;
+        v.k = static_cast<size_t>(std::stoul(arg));
+    } else if (kind == "above") {
+        v.kind = Kind::Threshold;
+        v.threshold = std::stod(arg);
+    } else if (kind == "ids") {
+        v.kind = Kind::IdSet;
+        std::stringstream ss(arg);
+        std::string tok;
+        while (std::getline(ss, tok, ';')) {
+            tok = trim(tok);
+            if (!tok.empty()) v.ids.push_back(tok);
+        }
+        std::sort(v.ids.begin(), v.ids.end());
+        v.ids.erase(std::unique(v.ids.begin(), v.ids.end()), v.ids.end());
+    } else {
+        throw std::invalid_argument("Unknown view kind: " + kind);
+    }
+    return v;
+}
+
+std::string View::key() const {
+    std::ostringstream os;
+    switch (kind) {
+        case Kind::TopK:      os << "topk:" << k; break;
+        case Kind::Threshold: os << "above:" << threshold; break;
+        case Kind::IdSet: {
+            os << "ids:";
+            for (size_t i = 0; i < ids.size(); ++i) os << (i ? ";" : "") << ids[i];
+            break;
+        }
+    }
+    return os.str();
+}
+
+SubscriptionId SubscriptionHub::subscribe(const View& view, NotifyFn fn) {
+    std::string key = view.key();
+    auto [it, inserted] = groups_.try_emplace(key);
+    if (inserted) it->second.view = view;
+
+    SubscriptionId id = nextId_++;
+    it->second.subs.emplace_back(id, std::move(fn));
+    owner_.emplace(id, key);
+    return id;
+}
+
+void SubscriptionHub::unsubscribe(SubscriptionId id) {
+    auto o = owner_.find(id);
+    if (o == owner_.end()) return;
+
+    auto g = groups_.find(o->second);
+    auto& subs = g->second.subs;
+    subs.erase(std::remove_if(subs.begin(), subs.end(),
+                              [id](const auto& s){ return s.first == id; }),
+               subs.end());
+    if (subs.empty()) groups_.erase(g);
+    owner_.erase(o);
+}
+
+static ViewEntry makeEntry(const TrackStore& store, TrackHandle h, size_t rank,
+                           const Thresholds& thr) {
+    return { store.id[h], suggestion(store.contact(h), store.score[h], thr), store.score[h], rank, {} };
+}
+
+static bool sameResult(const std::vector<ViewEntry>& a, const std::vector<ViewEntry>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].id != b[i].id || a[i].suggestion != b[i].suggestion) return false;
+    }
+    return true;
+}
+
+std::vector<ViewEntry> SubscriptionHub::evaluate(const View& v, const TrackStore& store,
+                                                 const Ranking& ranking,
+                                                 const std::vector<size_t>& rankOf,
+                                                 const Thresholds& thr,
+                                                 const TrackDeduplicator* dedup) const {
+    std::vector<ViewEntry> out;
+    switch (v.kind) {
+        case View::Kind::TopK: {
+            size_t n = std::min(v.k, ranking.size());
+            out.reserve(n);
+            for (size_t i = 0; i < n; ++i) out.push_back(makeEntry(store, ranking[i], i + 1, thr));
+            break;
+        }
+        case View::Kind::Threshold: {
+            // ranking is sorted, so the matches are a prefix
+            for (size_t i = 0; i < ranking.size() && store.score[ranking[i]] >= v.threshold; ++i) {
+                out.push_back(makeEntry(store, ranking[i], i + 1, thr));
+            }
+            std::sort(out.begin(), out.end(),
+                      [](const auto& a, const auto& b){ return a.id < b.id; });
+            break;
+        }
+        case View::Kind::IdSet: {
+            for (const auto& id : v.ids) {   // already sorted
+                auto h = store.find(id);
+                if (!h) continue;
+                // Filtered out of the ranking by dedup: its representative's rank
+                TrackHandle ranked = *h;
+                if (dedup && rankOf[*h] == 0) ranked = dedup->representative(*h);
+                out.push_back(makeEntry(store, *h, rankOf[ranked], thr));
+                if (ranked != *h) out.back().via = store.id[ranked];
+            }
+            break;
+        }
+    }
+    return out;
+}
+
+void SubscriptionHub::publish(uint64_t cycle, double time, const TrackStore& store,
+                              const Ranking& ranking,
+                              const Thresholds& thr, const TrackDeduplicator* dedup) {
+    // Rank lookup is only needed by id-set views; build it once if any exist
+    std::vector<size_t> rankOf;
+    for (const auto& [key, g] : groups_) {
+        if (g.view.kind == View::Kind::IdSet) {
+            rankOf.resize(store.size());
+            for (size_t i = 0; i < ranking.size(); ++i) rankOf[ranking[i]] = i + 1;
+            break;
+        }
+    }
+
+    for (auto& [key, g] : groups_) {
+        std::vector<ViewEntry> result = evaluate(g.view, store, ranking, rankOf, thr, dedup);
+        if (g.primed && sameResult(result, g.last)) continue;
+
+        Notification n { cycle, time, &g.view, &result, {}, {} };
+
+        std::vector<std::string> before, after;
+        for (const auto& e : g.last) before.push_back(e.id);
+        for (const auto& e : result) after.push_back(e.id);
+        std::sort(before.begin(), before.end());
+        std::sort(after.begin(), after.end());
+        std::set_difference(after.begin(), after.end(), before.begin(), before.end(),
+                            std::back_inserter(n.entered));
+        std::set_difference(before.begin(), before.end(), after.begin(), after.end(),
+                            std::back_inserter(n.left));
+
+        for (const auto& sub : g.subs) sub.second(n);
+
+        g.last = std::move(result);
+        g.primed = true;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dedup.hpp"
+#include "track_store.hpp"
+
+// -------------------- Subscriptions --------------------
+// A view is a standing query over the ranking. Its result is the list of
+// (id, suggestion) entries it selects; scores are reported but do not count
+// as a change, otherwise every cycle would notify.
+//   topk:K        top K tracks, in rank order
+//   above:SCORE   tracks scoring >= SCORE, sorted by id
+//   ids:A;B;C     the listed tracks that are present, sorted by id; a track
+//                 dedup merged into another is reported at that one's rank
+struct View {
+    enum class Kind { TopK, Threshold, IdSet };
+
+    Kind kind = Kind::TopK;
+    size_t k = 0;
+    double threshold = 0.0;
+    std::vector<std::string> ids;   // sorted, unique
+
+    // Throws std::invalid_argument on a bad spec.
+    static View parse(const std::string& spec);
+
+    // Canonical spec; equal views share one evaluation.
+    std::string key() const;
+};
+
+struct ViewEntry {
+    std::string id;
+    std::string suggestion;
+    double score;
+    size_t rank;   // 1-based
+    std::string via;   // representative's id when dedup hid this track
+};
+
+struct Notification {
+    uint64_t cycle;
+    double time;                      // stream time at the end of the cycle
+    const View* view;
+    const std::vector<ViewEntry>* result;
+    std::vector<std::string> entered; // ids new to the result
+    std::vector<std::string> left;    // ids no longer in the result
+};
+
+using SubscriptionId = uint64_t;
+using NotifyFn = std::function<void(const Notification&)>;
+
+// Fans change notifications out to local subscribers. Subscribers that
+// register the same view share one group: publish() evaluates each distinct
+// view once per cycle against the shared ranking, compares it to the
+// previous result and, only if it changed, builds a single notification
+// that is handed to every subscriber of the group. At most one
+// notification per view per cycle, however many updates the cycle held.
+class SubscriptionHub {
+public:
+    SubscriptionId subscribe(const View& view, NotifyFn fn);
+    void unsubscribe(SubscriptionId id);
+
+    size_t subscribers() const { return owner_.size(); }
+    size_t views() const { return groups_.size(); }
+
+    // ranking must be store.rank() for this cycle, filtered by dedup if
+    // given; thr is the cycle's suggestion thresholds. Callbacks must not
+    // (un)subscribe.
+    void publish(uint64_t cycle, double time, const TrackStore& store,
+                 const Ranking& ranking, const Thresholds& thr,
+                 const TrackDeduplicator* dedup = nullptr);
+
+private:
+    struct Group {
+        View view;
+        std::vector<ViewEntry> last;
+        bool primed = false;   // first publish always notifies
+        std::vector<std::pair<SubscriptionId, NotifyFn>> subs;
+    };
+
+    std::vector<ViewEntry> evaluate(const View& v, const TrackStore& store,
+                                    const Ranking& ranking,
+                                    const std::vector<size_t>& rankOf,
+                                    const Thresholds& thr, const TrackDeduplicator* dedup) const;
+
+    std::unordered_map<std::string, Group> groups_;
+    std::unordered_map<SubscriptionId, std::string> owner_;   // sub -> group key
+    SubscriptionId nextId_ = 1;
+};
@@ -0,0 +1,201 @@
+#include "terrain.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int16_t kVoid = -32768;
+// Positions within a tile in 1/16 of a 1" sample (about 2 m), which also
+// divides the 3" grid evenly
+constexpr double kFix = 3600.0 * 16.0;
+constexpr size_t kSlots = 256;                   // tiles per lookup chunk
+constexpr uint16_t kNoSlot = 0xffff;
+constexpr uint64_t kIndexMask = 0xffffff;
+constexpr size_t kMaxChunk = kIndexMask + 1;     // points per lookup chunk
+constexpr size_t kPrefetch = 16;                 // points ahead
+
+int16_t sample(const uint8_t* data, size_t side, size_t row, size_t col) {
+    const uint8_t* p = data + 2 * (row * side + col);
+    const int16_t v = static_cast<int16_t>((p[0] << 8) | p[1]);
+    return v == kVoid ? 0 : v;
+}
+
+} // namespace
+
+ElevationModel::ElevationModel(std::string dir, size_t maxTiles)
+    : dir_(std::move(dir)), maxTiles_(std::max<size_t>(1, maxTiles)) {
+    struct stat st;
+    if (::stat(dir_.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+        throw std::runtime_error("DEM directory not found: " + dir_);
+    }
+}
+
+ElevationModel::~ElevationModel() {
+    for (Tile& t : lru_) unmap(t);
+}
+
+void ElevationModel::unmap(Tile& t) {
+    if (t.data) munmap(const_cast<uint8_t*>(t.data), t.bytes);
+    t.data = nullptr;
+}
+
+const ElevationModel::Tile& ElevationModel::tile(uint32_t key) {
+    static const Tile kNoTile {};
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return lru_.front();
+    }
+    if (missing_.count(key)) return kNoTile;
+
+    const int latF = static_cast<int>(key / 360) - 90, lonF = static_cast<int>(key % 360) - 180;
+    char name[32];
+    std::snprintf(name, sizeof(name), "%c%02d%c%03d.hgt", latF < 0 ? 'S' : 'N', std::abs(latF),
+                  lonF < 0 ? 'W' : 'E', std::abs(lonF));
+    const std::string path = dir_ + "/" + name;
+
+    Tile t;
+    t.key = key;
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        missing_.insert(key);
+        ++stats_.missingTiles;
+        return kNoTile;
+    }
+    struct stat st;
+    const bool ok = fstat(fd, &st) == 0;
+    const size_t bytes = ok ? static_cast<size_t>(st.st_size) : 0;
+    const size_t side = static_cast<size_t>(std::llround(std::sqrt(bytes / 2.0)));
+    if (side < 2 || 2 * side * side != bytes) {
+        ::close(fd);
+        throw std::runtime_error("Not an SRTM tile (size is not 2 * side^2): " + path);
+    }
+    void* p = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) throw std::runtime_error("Failed to map DEM tile: " + path);
+    t.data = static_cast<const uint8_t*>(p);
+    t.bytes = bytes;
+    t.side = side;
+    ++stats_.tileLoads;
+
+    if (lru_.size() >= maxTiles_) {
+        unmap(lru_.back());
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+        ++stats_.evictions;
+    }
+    lru_.push_front(t);
+    index_[key] = lru_.begin();
+    return lru_.front();
+}
+
+void ElevationModel::lookup(size_t n, const double* lat_deg, const double* lon_deg, double* elev_m) {
+    stats_.lookups += n;
+    if (slotOf_.empty()) slotOf_.assign(180 * 360, kNoSlot);
+
+    for (size_t first = 0; first < n;) {
+        // Pack (tile slot << 56 | row << 40 | column << 24 | index). The
+        // slot is the tile's place among this chunk's tiles, and row and
+        // column are fixed point within the tile, so the sampling pass
+        // needs nothing but the key. A chunk ends early when it runs out of
+        // slots or index bits. Points without a usable position read 0 and
+        // are left out.
+        keyed_.clear();
+        size_t i = first;
+        for (; i < n && i - first < kMaxChunk; ++i) {
+            elev_m[i] = 0.0;
+            // Offsets make both non-negative, so truncation is floor
+            const double la = lat_deg[i] + 90.0, lo = lon_deg[i] + 540.0;
+            if (!(la >= 0.0 && la <= 180.0 && lo >= 0.0 && lo < 1080.0)) continue;
+            const int iy = std::min(179, static_cast<int>(la));
+            const int ix = static_cast<int>(lo);
+            const uint32_t key = static_cast<uint32_t>(iy * 360 + ix % 360);
+            if (slotOf_[key] == kNoSlot) {
+                if (chunkTiles_.size() == kSlots) break;
+                slotOf_[key] = static_cast<uint16_t>(chunkTiles_.size());
+                chunkTiles_.push_back(key);
+            }
+            const auto row = static_cast<uint64_t>((1.0 - (la - iy)) * kFix);
+            const auto col = static_cast<uint64_t>((lo - ix) * kFix);
+            keyed_.push_back((static_cast<uint64_t>(slotOf_[key]) << 56) | (row << 40) | (col << 24) |
+                             (i - first));
+        }
+
+        // LSD radix sort on the top 33 bits (slot, row, coarse column), 11
+        // per pass: each tile's points come out in memory order, so its
+        // pages are walked once
+        constexpr unsigned kBits = 11;
+        constexpr size_t kBuckets = size_t{1} << kBits;
+        radix_.resize(keyed_.size());
+        for (unsigned shift = 64 - 3 * kBits; shift < 64; shift += kBits) {
+            size_t count[kBuckets + 1] = {};
+            for (uint64_t k : keyed_) ++count[((k >> shift) & (kBuckets - 1)) + 1];
+            for (size_t d = 1; d <= kBuckets; ++d) count[d] += count[d - 1];
+            for (uint64_t k : keyed_) radix_[count[(k >> shift) & (kBuckets - 1)]++] = k;
+            keyed_.swap(radix_);
+        }
+
+        // One tile resolution per run, then bilinear samples. The points
+        // are sparse in the tile, so each one's rows are prefetched a few
+        // points ahead; the addresses come straight from the keys.
+        for (size_t b = 0; b < keyed_.size();) {
+            const uint64_t slot = keyed_[b] >> 56;
+            size_t e = b + 1;
+            while (e < keyed_.size() && (keyed_[e] >> 56) == slot) ++e;
+            const Tile& t = tile(chunkTiles_[slot]);
+            if (t.data) {
+                const double scale = static_cast<double>(t.side - 1) / kFix;
+                auto cellOf = [&](uint64_t key, double& y, double& x, size_t& r, size_t& c) {
+                    y = static_cast<double>((key >> 40) & 0xffff) * scale;
+                    x = static_cast<double>((key >> 24) & 0xffff) * scale;
+                    r = std::min(t.side - 2, static_cast<size_t>(y));
+                    c = std::min(t.side - 2, static_cast<size_t>(x));
+                };
+                for (size_t k = b; k < e; ++k) {
+                    double y, x;
+                    size_t r, c;
+                    if (k + kPrefetch < e) {
+                        cellOf(keyed_[k + kPrefetch], y, x, r, c);
+                        __builtin_prefetch(t.data + 2 * (r * t.side + c));
+                        __builtin_prefetch(t.data + 2 * ((r + 1) * t.side + c));
+                    }
+                    const uint64_t key = keyed_[k];
+                    cellOf(key, y, x, r, c);
+                    const double fy = y - static_cast<double>(r), fx = x - static_cast<double>(c);
+                    const double top = sample(t.data, t.side, r, c) * (1.0 - fx) + sample(t.data, t.side, r, c + 1) * fx;
+                    const double bot = sample(t.data, t.side, r + 1, c) * (1.0 - fx) + sample(t.data, t.side, r + 1, c + 1) * fx;
+                    elev_m[first + (key & kIndexMask)] = top * (1.0 - fy) + bot * fy;
+                }
+            }
+            b = e;
+        }
+
+        for (uint32_t key : chunkTiles_) slotOf_[key] = kNoSlot;
+        chunkTiles_.clear();
+        first = i;
+    }
+}
+
+void ElevationModel::annotate(std::vector<Update>& batch) {
+    lat_.clear();
+    lon_.clear();
+    for (const Update& u : batch) {
+        if (!u.c.has_geo) continue;
+        lat_.push_back(u.c.lat_deg);
+        lon_.push_back(u.c.lon_deg);
+    }
+    elev_.resize(lat_.size());
+    lookup(lat_.size(), lat_.data(), lon_.data(), elev_.data());
+    size_t i = 0;
+    for (Update& u : batch) {
+        if (u.c.has_geo) u.c.terrain_m = elev_[i++];
+    }
+}
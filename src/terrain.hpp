@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "stream.hpp"
+
+// -------------------- Terrain Elevation --------------------
+// Ground elevation from SRTM .hgt tiles in one directory: one file per
+// 1 x 1 degree cell named after its south-west corner (N52E013.hgt,
+// S05W072.hgt), holding 1201 x 1201 (3") or 3601 x 3601 (1") big-endian
+// int16 heights in metres, rows north to south. Tiles are memory-mapped on
+// first use and kept in an LRU cache of maxTiles. Cells without a file are
+// remembered in a set of their own, outside the LRU, so each is looked for
+// once and never takes a tile's place. Heights are bilinearly
+// interpolated; voids, the sea and cells without a tile read as 0.
+//
+// Lookups come in batches. Each batch is radix-sorted by tile, row and
+// column, so every tile is resolved once per batch and read in memory
+// order: pages and cache lines are fetched once and the prefetcher can
+// run ahead.
+struct TerrainStats {
+    uint64_t lookups = 0;
+    uint64_t tileLoads = 0;     // tiles mapped (first use or after eviction)
+    uint64_t missingTiles = 0;  // cells looked for with no file
+    uint64_t evictions = 0;
+};
+
+class ElevationModel {
+public:
+    explicit ElevationModel(std::string dir, size_t maxTiles = 16);
+    ~ElevationModel();
+
+    ElevationModel(const ElevationModel&) = delete;
+    ElevationModel& operator=(const ElevationModel&) = delete;
+
+    // Elevation (m) at n points
+    void lookup(size_t n, const double* lat_deg, const double* lon_deg, double* elev_m);
+
+    // Set terrain_m on every update with a geodetic position
+    void annotate(std::vector<Update>& batch);
+
+    const TerrainStats& stats() const { return stats_; }
+    size_t tilesMapped() const { return lru_.size(); }
+
+private:
+    struct Tile {
+        uint32_t key;                  // (lat + 90) * 360 + lon + 180 of the south-west corner
+        const uint8_t* data = nullptr; // nullptr: no file for this cell (kNoTile)
+        size_t bytes = 0;
+        size_t side = 0;               // samples per row
+    };
+
+    const Tile& tile(uint32_t key);
+    void unmap(Tile& t);
+
+    std::string dir_;
+    size_t maxTiles_;
+    std::list<Tile> lru_;                                       // most recent first
+    std::unordered_map<uint32_t, std::list<Tile>::iterator> index_;
+    std::unordered_set<uint32_t> missing_;                      // cells with no file
+    std::vector<uint64_t> keyed_, radix_;                       // batch sort scratch
+    std::vector<uint16_t> slotOf_;                              // by cell: slot in the chunk
+    std::vector<uint32_t> chunkTiles_;                          // by slot: cell
+    std::vector<double> lat_, lon_, elev_;                      // annotate scratch
+    TerrainStats stats_;
+};
@@ -0,0 +1,282 @@
+#include "track_filter.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+RangeRateTracker::RangeRateTracker(double alpha, double beta) : alpha_(alpha), beta_(beta) {}
+
+std::vector<TrackHandle> RangeRateTracker::update(TrackStore& store,
+                                                  const std::vector<TrackHandle>& touched) {
+    if (range_.size() < store.size()) {
+        range_.resize(store.size(), 0.0);
+        rate_.resize(store.size(), 0.0);
+        time_.resize(store.size(), 0.0);
+        samples_.resize(store.size(), 0);
+    }
+
+    constexpr size_t kBlock = 256;
+    // Sample counts ride along as doubles so the kernel is all one lane width
+    double z[kBlock], t[kBlock], x[kBlock], v[kBlock], tl[kBlock], n[kBlock];
+    std::vector<TrackHandle> changed;
+    const double a = alpha_, b = beta_;
+
+    for (size_t base = 0; base < touched.size(); base += kBlock) {
+        const size_t m = std::min(kBlock, touched.size() - base);
+        const TrackHandle* hs = touched.data() + base;
+        for (size_t i = 0; i < m; ++i) {
+            z[i]  = store.range_km[hs[i]];
+            t[i]  = store.last_seen[hs[i]];
+            x[i]  = range_[hs[i]];
+            v[i]  = rate_[hs[i]];
+            tl[i] = time_[hs[i]];
+            n[i]  = static_cast<double>(samples_[hs[i]]);
+        }
+
+        // First report seeds the range, the second the rate (two-point
+        // difference); after that predict and correct. A repeated timestamp
+        // gets zero weight, so the state stays as it was. Gains are scaled
+        // rather than old and new state selected: the selects share one
+        // condition, which GCC threads into branches that stop vectorization.
+        for (size_t i = 0; i < m; ++i) {
+            const double zi = z[i], xi = x[i], vi = v[i], ti = t[i], tli = tl[i], ni = n[i];
+            const double dt = ti - tli;
+            const bool first = ni == 0.0;
+            const double w = (first | (dt > 0.0)) ? 1.0 : 0.0;
+            const double inv = w / (dt > 0.0 ? dt : 1.0);
+
+            const double xp = xi + vi * dt * w;
+            const double r = zi - xp;
+            const double xSteady = xp + a * w * r;
+            const double vSteady = vi + b * r * inv;
+            const double vSecond = vi + (zi - xi) * inv;
+
+            x[i]  = ni < 2.0 ? xi + w * (zi - xi) : xSteady;
+            v[i]  = first ? 0.0 : ni == 1.0 ? vSecond : vSteady;
+            tl[i] = w != 0.0 ? ti : tli;
+            n[i]  = ni + w;
+        }
+
+        for (size_t i = 0; i < m; ++i) {
+            const TrackHandle h = hs[i];
+            range_[h] = x[i];
+            rate_[h] = v[i];
+            time_[h] = tl[i];
+            samples_[h] = static_cast<uint32_t>(n[i]);
+            if (store.has_closing[h] || n[i] < 2.0) continue;
+            const double closing = -v[i] * 1000.0;   // km/s -> m/s, positive closing
+            if (store.closing_mps[h] != closing) {
+                store.closing_mps[h] = closing;
+                store.markDirty(h);
+                changed.push_back(h);
+            }
+        }
+    }
+    return changed;
+}
+
+// -------------------- Smoothing --------------------
+namespace {
+
+constexpr size_t kBlock = 256;
+
+// Per-lane timing shared by every channel of a block. A lane with w = 0
+// (repeated timestamp) must leave its state untouched; first = 1 seeds it.
+struct Lanes {
+    double dt[kBlock];      // elapsed time, 0 unless the report is used
+    double w[kBlock];       // 1 if the report is folded in
+    double first[kBlock];   // 1 if it is the track's first report
+};
+
+// Measurement variances are (sigma)^2 in the channel's units: range km,
+// altitude m.
+const ChannelParams kRangeParams    { 0.5, 0.2, 0.05 * 0.05, 0.01 * 0.01, 0.5 * 0.5 };
+const ChannelParams kAltitudeParams { 0.5, 0.2, 30.0 * 30.0, 3.0 * 3.0, 50.0 * 50.0 };
+
+void alphaBetaChannel(size_t m, const Lanes& l, const double* z, const ChannelParams& cp,
+                      double* x, double* v) {
+    for (size_t i = 0; i < m; ++i) {
+        const double dt = l.dt[i], w = l.w[i], f = l.first[i];
+        const double xp = x[i] + v[i] * dt;
+        const double r = z[i] - xp;
+        const double nx = xp + cp.alpha * w * r;
+        const double nv = v[i] + cp.beta * w * r / (dt > 0.0 ? dt : 1.0);
+        x[i] = f != 0.0 ? z[i] : nx;
+        v[i] = nv * (1.0 - f);
+    }
+}
+
+// Gathered into Mat, stepped with the model's matrices, scattered back: the
+// matrix code unrolls into straight-line arithmetic per lane.
+template <class Model>
+void kalmanChannel(size_t m, const Lanes& l, const double* z, const ChannelParams& cp,
+                   double* x, double* v, double* p00, double* p01, double* p11) {
+    static_assert(Model::N == 2 && Model::M == 1, "state is stored as position, velocity");
+    const Mat<Model::M, Model::M> R {{{ cp.measVar }}};
+    const auto H = Model::H();
+    const auto I = Mat<Model::N, Model::N>::identity();
+
+    for (size_t i = 0; i < m; ++i) {
+        const double dt = l.dt[i], w = l.w[i], f = l.first[i];
+        const Mat<Model::N, 1> xs {{{ x[i] }, { v[i] }}};
+        const Mat<Model::N, Model::N> P {{{ p00[i], p01[i] }, { p01[i], p11[i] }}};
+
+        const auto F = Model::F(dt);
+        const auto xp = F * xs;
+        const auto Pp = F * P * transpose(F) + Model::Q(dt, cp.accelVar);
+        const Mat<Model::M, 1> zz {{{ z[i] }}};
+        const auto S = H * Pp * transpose(H) + R;
+        const auto K = w * (Pp * transpose(H) * inverse(S));
+        const auto xn = xp + K * (zz - H * xp);
+        const auto Pn = (I - K * H) * Pp;
+
+        // First report: position from the measurement, velocity unknown
+        x[i]   = f != 0.0 ? z[i] : xn(0, 0);
+        v[i]   = xn(1, 0) * (1.0 - f);
+        p00[i] = Pn(0, 0) + f * (cp.measVar - Pn(0, 0));
+        p01[i] = Pn(0, 1) * (1.0 - f);
+        p11[i] = Pn(1, 1) + f * (cp.velVar0 - Pn(1, 1));
+    }
+}
+
+} // namespace
+
+FilterKind parseFilterKind(const std::string& s) {
+    if (s == "ab") return FilterKind::AlphaBeta;
+    if (s == "kalman") return FilterKind::Kalman;
+    throw std::runtime_error("Unknown filter '" + s + "' (expected ab or kalman)");
+}
+
+TrackSmoother::TrackSmoother(FilterKind kind) : kind_(kind) {
+    range_.params = kRangeParams;
+    alt_.params = kAltitudeParams;
+}
+
+void TrackSmoother::grow(size_t n) {
+    if (time_.size() >= n) return;
+    for (Channel* c : { &range_, &alt_ }) {
+        c->x.resize(n, 0.0);
+        c->v.resize(n, 0.0);
+        if (kind_ == FilterKind::Kalman) {
+            c->p00.resize(n, 0.0);
+            c->p01.resize(n, 0.0);
+            c->p11.resize(n, 0.0);
+        }
+    }
+    time_.resize(n, 0.0);
+    samples_.resize(n, 0);
+}
+
+void TrackSmoother::step(size_t n, const TrackHandle* hs, const double* time,
+                         double* range_km, double* altitude_m) {
+    if (n == 0) return;
+    grow(static_cast<size_t>(*std::max_element(hs, hs + n)) + 1);
+
+    Lanes l;
+    double x[2][kBlock], v[2][kBlock], p00[2][kBlock], p01[2][kBlock], p11[2][kBlock];
+    Channel* chans[2] = { &range_, &alt_ };
+    double* meas[2] = { range_km, altitude_m };
+    const bool kalman = kind_ == FilterKind::Kalman;
+
+    for (size_t base = 0; base < n; base += kBlock) {
+        const size_t m = std::min(kBlock, n - base);
+        const TrackHandle* h = hs + base;
+        const double* t = time + base;
+
+        for (size_t i = 0; i < m; ++i) {
+            const double dt = t[i] - time_[h[i]];
+            const bool first = samples_[h[i]] == 0;
+            l.first[i] = first ? 1.0 : 0.0;
+            l.w[i] = (first || dt > 0.0) ? 1.0 : 0.0;
+            l.dt[i] = (!first && dt > 0.0) ? dt : 0.0;
+        }
+        for (size_t c = 0; c < 2; ++c) {
+            const Channel& ch = *chans[c];
+            for (size_t i = 0; i < m; ++i) {
+                x[c][i] = ch.x[h[i]];
+                v[c][i] = ch.v[h[i]];
+            }
+            if (!kalman) continue;
+            for (size_t i = 0; i < m; ++i) {
+                p00[c][i] = ch.p00[h[i]];
+                p01[c][i] = ch.p01[h[i]];
+                p11[c][i] = ch.p11[h[i]];
+            }
+        }
+
+        for (size_t c = 0; c < 2; ++c) {
+            const double* z = meas[c] + base;
+            if (kalman) kalmanChannel<ConstantVelocity>(m, l, z, chans[c]->params, x[c], v[c], p00[c], p01[c], p11[c]);
+            else alphaBetaChannel(m, l, z, chans[c]->params, x[c], v[c]);
+        }
+
+        for (size_t c = 0; c < 2; ++c) {
+            Channel& ch = *chans[c];
+            double* out = meas[c] + base;
+            for (size_t i = 0; i < m; ++i) {
+                ch.x[h[i]] = x[c][i];
+                ch.v[h[i]] = v[c][i];
+                out[i] = x[c][i];
+            }
+            if (!kalman) continue;
+            for (size_t i = 0; i < m; ++i) {
+                ch.p00[h[i]] = p00[c][i];
+                ch.p01[h[i]] = p01[c][i];
+                ch.p11[h[i]] = p11[c][i];
+            }
+        }
+        for (size_t i = 0; i < m; ++i) {
+            if (l.w[i] == 0.0) continue;
+            time_[h[i]] = t[i];
+            ++samples_[h[i]];
+        }
+    }
+}
+
+void TrackSmoother::update(TrackStore& store, const std::vector<TrackHandle>& touched) {
+    double t[kBlock], r[kBlock], a[kBlock];
+    for (size_t base = 0; base < touched.size(); base += kBlock) {
+        const size_t m = std::min(kBlock, touched.size() - base);
+        const TrackHandle* hs = touched.data() + base;
+        for (size_t i = 0; i < m; ++i) {
+            t[i] = store.last_seen[hs[i]];
+            r[i] = store.range_km[hs[i]];
+            a[i] = store.altitude_m[hs[i]];
+        }
+        step(m, hs, t, r, a);
+        for (size_t i = 0; i < m; ++i) {
+            store.range_km[hs[i]] = r[i];
+            store.altitude_m[hs[i]] = a[i];
+        }
+    }
+}
+
+// -------------------- Ground Velocity --------------------
+void TrackMotion::observe(const TrackStore& store, const std::vector<TrackHandle>& touched) {
+    if (state_.size() < store.size()) {
+        posE_.resize(store.size(), 0.0);
+        posN_.resize(store.size(), 0.0);
+        posT_.resize(store.size(), 0.0);
+        velE_.resize(store.size(), 0.0);
+        velN_.resize(store.size(), 0.0);
+        state_.resize(store.size(), 0);
+    }
+    for (TrackHandle h : touched) {
+        if (!store.has_pos[h]) continue;
+        const double t = store.last_seen[h];
+        const double e = store.east_km[h], n = store.north_km[h];
+        if (state_[h] != 0 && t > posT_[h]) {
+            const double ve = (e - posE_[h]) / (t - posT_[h]);
+            const double vn = (n - posN_[h]) / (t - posT_[h]);
+            // Light smoothing once there is an estimate to smooth
+            const double g = state_[h] == 2 ? 0.5 : 1.0;
+            velE_[h] += g * (ve - velE_[h]);
+            velN_[h] += g * (vn - velN_[h]);
+            state_[h] = 2;
+        } else if (state_[h] == 0) {
+            state_[h] = 1;
+        }
+        posE_[h] = e;
+        posN_[h] = n;
+        posT_[h] = t;
+    }
+}
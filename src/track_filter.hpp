@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "hugepages.hpp"
+#include "matrix.hpp"
+#include "track_store.hpp"
+
+// -------------------- Range-Rate Estimation --------------------
+// Per-track alpha-beta filter on range, so continuous mode can derive
+// closing_mps for feeds that leave it empty. Filter state is column-wise by
+// track handle; each cycle the touched tracks are gathered into dense
+// blocks, stepped together in one branch-free loop and scattered back.
+// Tracks that report closing speed are still filtered (their history is
+// kept) but their reported value is never overridden.
+class RangeRateTracker {
+public:
+    explicit RangeRateTracker(double alpha = 0.5, double beta = 0.2);
+
+    // Step the filters of the touched tracks with their latest range and
+    // time, then set closing_mps = -range rate for those without a reported
+    // closing speed. Returns the handles whose closing_mps changed (they
+    // need rescoring).
+    std::vector<TrackHandle> update(TrackStore& store, const std::vector<TrackHandle>& touched);
+
+    // Range rate estimate (km/s, negative when closing); 0 until two reports
+    double rate(TrackHandle h) const { return h < rate_.size() ? rate_[h] : 0.0; }
+    uint32_t samples(TrackHandle h) const { return h < samples_.size() ? samples_[h] : 0; }
+
+private:
+    double alpha_;
+    double beta_;
+    HugeVector<double> range_;      // filtered range (km)
+    HugeVector<double> rate_;       // km/s
+    HugeVector<double> time_;       // time of the last report (s)
+    HugeVector<uint32_t> samples_;  // reports folded in
+};
+
+// -------------------- Smoothing --------------------
+// Per-track filtering of the noisy measurements that feed score(): range
+// and altitude each run a constant-velocity model, and the store's columns
+// are overwritten with the filtered values before the tracks are rescored.
+// State is column-wise like RangeRateTracker's and stepped block by block.
+enum class FilterKind { AlphaBeta, Kalman };
+
+// "ab" or "kalman"; throws on anything else
+FilterKind parseFilterKind(const std::string& s);
+
+// Constant-velocity model, state [position, velocity], position measured.
+// Process noise is white acceleration of variance q.
+struct ConstantVelocity {
+    static constexpr size_t N = 2;
+    static constexpr size_t M = 1;
+
+    static Mat<N, N> F(double dt) { return {{{ 1.0, dt }, { 0.0, 1.0 }}}; }
+    static Mat<N, N> Q(double dt, double q) {
+        const double dt2 = dt * dt;
+        return {{{ q * dt2 * dt / 3.0, q * dt2 / 2.0 }, { q * dt2 / 2.0, q * dt }}};
+    }
+    static Mat<M, N> H() { return {{{ 1.0, 0.0 }}}; }
+};
+
+// Tuning of one measured quantity
+struct ChannelParams {
+    double alpha;      // alpha-beta position gain
+    double beta;       // alpha-beta velocity gain
+    double measVar;    // Kalman measurement variance
+    double accelVar;   // Kalman process noise
+    double velVar0;    // Kalman initial velocity variance
+};
+
+class TrackSmoother {
+public:
+    explicit TrackSmoother(FilterKind kind);
+
+    // Step the touched tracks' filters with their latest report and replace
+    // range_km and altitude_m with the filtered values. The caller rescores.
+    void update(TrackStore& store, const std::vector<TrackHandle>& touched);
+
+    // The same step on plain arrays: n reports for the filters of tracks
+    // hs[0..n), each track at most once. range and altitude are replaced
+    // with the filtered values.
+    void step(size_t n, const TrackHandle* hs, const double* time,
+              double* range_km, double* altitude_m);
+
+    FilterKind kind() const { return kind_; }
+
+private:
+    struct Channel {
+        ChannelParams params;
+        HugeVector<double> x, v;            // position, velocity
+        HugeVector<double> p00, p01, p11;   // covariance (Kalman only)
+    };
+
+    void grow(size_t n);
+
+    FilterKind kind_;
+    Channel range_;
+    Channel alt_;
+    HugeVector<double> time_;
+    HugeVector<uint32_t> samples_;
+};
+
+// -------------------- Ground Velocity --------------------
+// East/north velocity of each track from its successive reported positions,
+// lightly smoothed. Plot association predicts with it and grouping compares
+// it; tracks without a position are left alone.
+class TrackMotion {
+public:
+    // Fold in the touched tracks' latest positions. Call after each applyBatch.
+    void observe(const TrackStore& store, const std::vector<TrackHandle>& touched);
+
+    // Two positions at different times are needed for a velocity
+    bool hasVelocity(TrackHandle h) const { return h < state_.size() && state_[h] == 2; }
+    double velE(TrackHandle h) const { return velE_[h]; }   // km/s
+    double velN(TrackHandle h) const { return velN_[h]; }
+
+private:
+    HugeVector<double> posE_, posN_;   // last position (km)
+    HugeVector<double> posT_;          // and its time
+    HugeVector<double> velE_, velN_;
+    HugeVector<uint8_t> state_;        // 0 none, 1 position, 2 position + velocity
+};
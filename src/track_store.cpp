@@ -0,0 +1,172 @@
+#include "track_store.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+std::optional<TrackHandle> TrackStore::find(const std::string& trackId) const {
+    auto it = index_.find(trackId);
+    if (it == index_.end()) return std::nullopt;
+    return it->second;
+}
+
+TrackHandle TrackStore::intern(const std::string& trackId) {
+    auto [it, inserted] = index_.try_emplace(trackId, static_cast<TrackHandle>(id.size()));
+    if (inserted) {
+        id.push_back(trackId);
+        iff.push_back(IFF::Unknown);
+        range_km.push_back(0.0);
+        closing_mps.push_back(0.0);
+        has_closing.push_back(1);
+        altitude_m.push_back(0.0);
+        rcs_m2.push_back(0.0);
+        has_pos.push_back(0);
+        east_km.push_back(0.0);
+        north_km.push_back(0.0);
+        terrain_m.push_back(0.0);
+        platform.push_back(Platform::Unclassified);
+        last_seen.push_back(0.0);
+        score.push_back(0.0);
+        markDirty(it->second);
+    }
+    return it->second;
+}
+
+TrackHandle TrackStore::upsert(const Contact& c, double t) {
+    TrackHandle h = intern(c.id);
+    write(h, c, t);
+    return h;
+}
+
+void TrackStore::write(TrackHandle h, const Contact& c, double t) {
+    iff[h]         = c.iff;
+    range_km[h]    = c.range_km;
+    closing_mps[h] = c.closing_mps;
+    has_closing[h] = c.has_closing ? 1 : 0;
+    altitude_m[h]  = c.altitude_m;
+    rcs_m2[h]      = c.rcs_m2;
+    has_pos[h]     = c.has_pos ? 1 : 0;
+    east_km[h]     = c.east_km;
+    north_km[h]    = c.north_km;
+    terrain_m[h]   = c.terrain_m;
+    // A class, once reported, outlives updates from feeds that have none
+    platform[h]    = c.platform != Platform::Unclassified ? c.platform : platform[h];
+    last_seen[h]   = t;
+    markDirty(h);
+}
+
+Contact TrackStore::contact(TrackHandle h) const {
+    Contact c { id[h], iff[h], range_km[h], closing_mps[h], altitude_m[h], rcs_m2[h] };
+    c.has_closing = has_closing[h] != 0;
+    c.has_pos     = has_pos[h] != 0;
+    c.east_km     = east_km[h];
+    c.north_km    = north_km[h];
+    c.terrain_m   = terrain_m[h];
+    c.platform    = platform[h];
+    return c;
+}
+
+void TrackStore::rescore(const Weights& w) {
+    for (TrackHandle h = 0; h < size(); ++h) {
+        setScore(h, scoreFromFeatures(features(h), w));
+    }
+}
+
+void TrackStore::rescore(const Weights& w, const std::vector<TrackHandle>& handles) {
+    constexpr size_t kBlock = 256;
+    double r[kBlock], cl[kBlock], al[kBlock], rc[kBlock], out[kBlock];
+    IFF ff[kBlock];
+    Platform pf[kBlock];
+
+    for (size_t b = 0; b < handles.size(); b += kBlock) {
+        const size_t n = std::min(kBlock, handles.size() - b);
+        const TrackHandle* hs = handles.data() + b;
+        for (size_t i = 0; i < n; ++i) {
+            r[i]  = range_km[hs[i]];
+            cl[i] = closing_mps[hs[i]];
+            al[i] = altitude_m[hs[i]] - terrain_m[hs[i]];   // above ground
+            rc[i] = rcs_m2[hs[i]];
+            ff[i] = iff[hs[i]];
+            pf[i] = platform[hs[i]];
+        }
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = scoreFromFeatures(scoreFeatures(r[i], ff[i], cl[i], al[i], rc[i], pf[i]), w);
+        }
+        for (size_t i = 0; i < n; ++i) setScore(hs[i], out[i]);
+    }
+}
+
+std::vector<TrackHandle> TrackStore::applyBatch(const std::vector<Update>& batch,
+                                                const Weights& w, BatchStats* stats) {
+    const size_t before = size();
+
+    // 1. Resolve handles; pack (handle << 32 | arrival index)
+    radixA_.resize(batch.size());
+    radixB_.resize(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        radixA_[i] = (static_cast<uint64_t>(intern(batch[i].c.id)) << 32) | i;
+    }
+
+    // 2. LSD radix sort on the handle half, 11 bits per pass, skipping passes
+    //    above the largest handle
+    constexpr unsigned kBits = 11;
+    constexpr size_t kBuckets = size_t{1} << kBits;
+    unsigned handleBits = 0;
+    while (handleBits < 32 && (size() >> handleBits) != 0) ++handleBits;
+    for (unsigned shift = 32; shift < 32 + handleBits; shift += kBits) {
+        size_t count[kBuckets + 1] = {};
+        for (uint64_t k : radixA_) ++count[((k >> shift) & (kBuckets - 1)) + 1];
+        for (size_t d = 1; d <= kBuckets; ++d) count[d] += count[d - 1];
+        for (uint64_t k : radixA_) radixB_[count[(k >> shift) & (kBuckets - 1)]++] = k;
+        radixA_.swap(radixB_);
+    }
+
+    // 3./4. Collapse each handle's run to its latest update (ties go to the
+    //       later arrival) and write in handle order. A class reported by
+    //       a dropped update still counts if the latest carries none.
+    std::vector<TrackHandle> touched;
+    touched.reserve(batch.size());
+    for (size_t i = 0; i < radixA_.size();) {
+        const TrackHandle h = static_cast<TrackHandle>(radixA_[i] >> 32);
+        size_t best = radixA_[i] & 0xffffffffu;
+        size_t classed = batch[best].c.platform != Platform::Unclassified ? best : SIZE_MAX;
+        for (++i; i < radixA_.size() && (radixA_[i] >> 32) == h; ++i) {
+            size_t idx = radixA_[i] & 0xffffffffu;
+            if (batch[idx].t >= batch[best].t) best = idx;
+            if (batch[idx].c.platform != Platform::Unclassified &&
+                (classed == SIZE_MAX || batch[idx].t >= batch[classed].t)) classed = idx;
+        }
+        if (batch[best].c.platform == Platform::Unclassified && classed != SIZE_MAX) {
+            Contact c = batch[best].c;
+            c.platform = batch[classed].c.platform;
+            write(h, c, batch[best].t);
+        } else {
+            write(h, batch[best].c, batch[best].t);
+        }
+        touched.push_back(h);
+    }
+
+    // 5. Dense rescore of just the touched tracks
+    rescore(w, touched);
+
+    if (stats) {
+        stats->updates = batch.size();
+        stats->applied = touched.size();
+        stats->created = size() - before;
+    }
+    return touched;
+}
+
+void TrackStore::markDirty(TrackHandle h) {
+    size_t c = h / kChunkRows;
+    if (c >= dirty_.size()) dirty_.resize(c + 1, 0);
+    dirty_[c] = 1;
+}
+
+Ranking TrackStore::rank() const {
+    Ranking order(size());
+    std::iota(order.begin(), order.end(), TrackHandle{0});
+    std::sort(order.begin(), order.end(), [this](TrackHandle a, TrackHandle b) {
+        return score[a] != score[b] ? score[a] > score[b] : a < b;
+    });
+    return order;
+}
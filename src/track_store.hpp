@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "contact.hpp"
+#include "hugepages.hpp"
+#include "scoring.hpp"
+#include "stream.hpp"
+
+// -------------------- Track Store --------------------
+// Live track picture for continuous (serve) mode. Track ids are interned to
+// dense handles on first sight; everything else is kept column-wise so the
+// per-cycle rescore is a straight sweep.
+using TrackHandle = uint32_t;
+using Ranking = HugeVector<TrackHandle>;   // handles, best first
+
+struct TrackStore {
+    // Rows are grouped in fixed chunks for copy-on-write snapshots; a chunk
+    // is dirty once any row in it changes and stays so until clearDirty().
+    static constexpr size_t kChunkRows = 1024;
+
+    std::vector<std::string> id;
+    HugeVector<IFF>          iff;
+    HugeVector<double>       range_km;
+    HugeVector<double>       closing_mps;
+    HugeVector<uint8_t>      has_closing;   // closing_mps was reported
+    HugeVector<double>       altitude_m;
+    HugeVector<double>       rcs_m2;
+    HugeVector<uint8_t>      has_pos;
+    HugeVector<double>       east_km;
+    HugeVector<double>       north_km;
+    HugeVector<double>       terrain_m;   // ground elevation; the altitude term scores height above it
+    HugeVector<Platform>     platform;    // kept when an update carries no class
+    HugeVector<double>       last_seen;   // stream time of the last update (s)
+    HugeVector<double>       score;
+
+    size_t size() const { return id.size(); }
+
+    std::optional<TrackHandle> find(const std::string& trackId) const;
+
+    // Find or append the track; new tracks start zeroed.
+    TrackHandle intern(const std::string& trackId);
+
+    // Overwrite the track's measurements (interning it if needed).
+    TrackHandle upsert(const Contact& c, double t);
+
+    Contact contact(TrackHandle h) const;
+
+    ScoreFeatures features(TrackHandle h) const {
+        return scoreFeatures(range_km[h], iff[h], closing_mps[h], altitude_m[h] - terrain_m[h], rcs_m2[h],
+                             platform[h]);
+    }
+
+    void setScore(TrackHandle h, double s) {
+        if (score[h] != s) { score[h] = s; markDirty(h); }
+    }
+
+    void rescore(const Weights& w);
+
+    // Rescore only the given handles, gathering their inputs into dense
+    // blocks so the scoring loop runs over contiguous memory.
+    void rescore(const Weights& w, const std::vector<TrackHandle>& handles);
+
+    // Apply a batch of updates together: resolve handles, radix-partition
+    // by handle (stable, so arrival order survives within a track), keep
+    // only the latest update per track, write the survivors in memory order
+    // and rescore the touched tracks as one dense batch. Returns the touched
+    // handles in ascending order. The dropped updates are lost to the range
+    // filters, which step once per track per batch on what is written; only
+    // their platform class is kept, when the latest update has none.
+    struct BatchStats {
+        size_t updates = 0;     // in the batch
+        size_t applied = 0;     // distinct tracks written
+        size_t created = 0;     // new tracks among them
+    };
+    std::vector<TrackHandle> applyBatch(const std::vector<Update>& batch, const Weights& w,
+                                        BatchStats* stats = nullptr);
+
+    size_t chunks() const { return (size() + kChunkRows - 1) / kChunkRows; }
+    bool chunkDirty(size_t chunk) const { return chunk < dirty_.size() && dirty_[chunk]; }
+    void markDirty(TrackHandle h);
+    void clearDirty() { std::fill(dirty_.begin(), dirty_.end(), 0); }
+
+    // Handles sorted by descending score (ties by handle, so stable).
+    Ranking rank() const;
+
+private:
+    void write(TrackHandle h, const Contact& c, double t);
+
+    std::unordered_map<std::string, TrackHandle> index_;
+    std::vector<uint8_t> dirty_;   // per chunk
+    std::vector<uint64_t> radixA_, radixB_;   // applyBatch scratch
+};
@@ -0,0 +1,134 @@
+#include "track_summary.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <unordered_map>
+
+#include "common.hpp"
+
+namespace {
+
+constexpr unsigned kPartitionBits = 6;
+constexpr size_t kPartitions = size_t(1) << kPartitionBits;
+
+size_t partitionOf(uint32_t id) { return (id * 0x9E3779B1u) >> (32 - kPartitionBits); }
+
+// Aggregate of one track over a run of consecutive updates
+struct Partial {
+    uint32_t id;
+    IFF lastIff;
+    Suggestion lastState;
+    double first, last;
+    double minRange, maxScore;
+    double dwell[kSuggestions];
+    size_t updates;
+};
+
+// Fold b, which starts no earlier than a ends, into a
+void fold(Partial& a, const Partial& b) {
+    a.dwell[size_t(a.lastState)] += b.first - a.last;
+    for (size_t s = 0; s < kSuggestions; ++s) a.dwell[s] += b.dwell[s];
+    a.last = b.last;
+    a.lastState = b.lastState;
+    a.lastIff = b.lastIff;
+    a.minRange = std::min(a.minRange, b.minRange);
+    a.maxScore = std::max(a.maxScore, b.maxScore);
+    a.updates += b.updates;
+}
+
+} // namespace
+
+std::vector<TrackSummary> summarizeTracks(const Archive& ar, const Weights& w,
+                                          const Thresholds& thr, size_t threads,
+                                          double from, double to) {
+    std::vector<size_t> groups;
+    for (size_t g = 0; g < ar.groups(); ++g) {
+        const ZoneMap& z = ar.rowGroup(g).zone;
+        if (z.hi[size_t(ArchiveField::Time)] >= from && z.lo[size_t(ArchiveField::Time)] <= to) {
+            groups.push_back(g);
+        }
+    }
+    threads = std::max<size_t>(1, threads);
+
+    // Phase one: partials per (row group, partition)
+    std::vector<std::array<std::vector<Partial>, kPartitions>> parts(groups.size());
+    std::atomic<size_t> next{0};
+    parallel(std::min(threads, std::max<size_t>(1, groups.size())), [&](size_t) {
+        std::unordered_map<uint32_t, uint32_t> slot;
+        std::vector<Partial> local;
+        for (size_t k; (k = next.fetch_add(1)) < groups.size();) {
+            const Archive::Group grp = ar.group(groups[k]);
+            const double* t       = grp.num[size_t(ArchiveField::Time)];
+            const double* range   = grp.num[size_t(ArchiveField::Range)];
+            const double* closing = grp.num[size_t(ArchiveField::Closing)];
+            const double* alt     = grp.num[size_t(ArchiveField::Altitude)];
+            const double* rcs     = grp.num[size_t(ArchiveField::Rcs)];
+            const double* terrain = grp.num[size_t(ArchiveField::Terrain)];
+            slot.clear();
+            local.clear();
+            for (size_t i = 0; i < grp.rows; ++i) {
+                if (t[i] < from || t[i] > to) continue;
+                const IFF iff = static_cast<IFF>(grp.iff[i]);
+                const Platform cls = static_cast<Platform>(grp.platform[i]);
+                const double s = scoreFromFeatures(
+                    scoreFeatures(range[i], iff, closing[i], alt[i] - terrain[i], rcs[i], cls), w);
+                const Suggestion level = suggestionLevel(iff, cls, range[i], closing[i], s, thr);
+
+                auto [it, fresh] = slot.try_emplace(grp.id[i], static_cast<uint32_t>(local.size()));
+                if (fresh) {
+                    local.push_back({ grp.id[i], iff, level, t[i], t[i], range[i], s, {}, 1 });
+                    continue;
+                }
+                Partial& p = local[it->second];
+                p.dwell[size_t(p.lastState)] += t[i] - p.last;
+                p.last = t[i];
+                p.lastState = level;
+                p.lastIff = iff;
+                p.minRange = std::min(p.minRange, range[i]);
+                p.maxScore = std::max(p.maxScore, s);
+                ++p.updates;
+            }
+            for (const Partial& p : local) parts[k][partitionOf(p.id)].push_back(p);
+        }
+    });
+
+    // Phase two: merge each partition, group by group in time order
+    std::vector<std::vector<TrackSummary>> merged(kPartitions);
+    next = 0;
+    parallel(std::min(threads, kPartitions), [&](size_t) {
+        std::unordered_map<uint32_t, Partial> agg;
+        for (size_t p; (p = next.fetch_add(1)) < kPartitions;) {
+            agg.clear();
+            for (const auto& group : parts) {
+                for (const Partial& x : group[p]) {
+                    auto [it, fresh] = agg.try_emplace(x.id, x);
+                    if (!fresh) fold(it->second, x);
+                }
+            }
+            auto& out = merged[p];
+            out.reserve(agg.size());
+            for (const auto& [id, a] : agg) {
+                TrackSummary s;
+                s.id = ar.ids()[id];
+                s.iff = a.lastIff;
+                s.first_seen = a.first;
+                s.last_seen = a.last;
+                s.min_range_km = a.minRange;
+                s.max_score = a.maxScore;
+                std::copy(std::begin(a.dwell), std::end(a.dwell), std::begin(s.dwell_s));
+                s.updates = a.updates;
+                out.push_back(std::move(s));
+            }
+        }
+    });
+
+    std::vector<TrackSummary> out;
+    for (auto& m : merged) {
+        out.insert(out.end(), std::make_move_iterator(m.begin()), std::make_move_iterator(m.end()));
+    }
+    std::sort(out.begin(), out.end(), [](const TrackSummary& a, const TrackSummary& b) {
+        return a.max_score != b.max_score ? a.max_score > b.max_score : a.id < b.id;
+    });
+    return out;
+}
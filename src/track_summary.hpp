@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "archive.hpp"
+#include "contact.hpp"
+#include "scoring.hpp"
+
+// -------------------- Per-Track Summaries --------------------
+// Aggregates over an archive, one row per track id. A track is taken to hold
+// the suggestion of an update until its next update, so dwell time in a state
+// is the sum of the gaps that start in it; the last update adds none.
+//
+// Computed as a partitioned parallel hash aggregation. Phase one scores the
+// row groups in parallel and folds each group into partial aggregates per
+// track, scattered by id hash into partitions. Phase two merges each
+// partition in parallel, folding the partials in row-group (time) order so
+// gaps across group boundaries are attributed correctly.
+struct TrackSummary {
+    std::string id;
+    IFF iff = IFF::Unknown;            // as of the last update
+    double first_seen = 0.0;
+    double last_seen = 0.0;
+    double min_range_km = std::numeric_limits<double>::infinity();
+    double max_score = -std::numeric_limits<double>::infinity();
+    double dwell_s[kSuggestions] = {};  // by Suggestion
+    size_t updates = 0;
+};
+
+// Tracks with an update in [from, to], sorted by descending max score.
+std::vector<TrackSummary> summarizeTracks(const Archive& ar, const Weights& w,
+                                          const Thresholds& thr, size_t threads,
+                                          double from = -std::numeric_limits<double>::infinity(),
+                                          double to = std::numeric_limits<double>::infinity());
@@ -0,0 +1,171 @@
+#include "window.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+WindowSpec WindowSpec::parse(const std::string& spec) {
+    std::stringstream ss(spec);
+    std::string kind, len, agg;
+    std::getline(ss, kind, ':');
+    std::getline(ss, len, ':');
+    std::getline(ss, agg, ':');
+
+    WindowSpec w;
+    if (kind == "sliding") w.kind = Kind::Sliding;
+    else if (kind == "tumbling") w.kind = Kind::Tumbling;
+    else throw std::invalid_argument("Unknown window kind (want sliding|tumbling): " + spec);
+
+    if (!isNumeric(len) || (w.length_s = std::stod(len)) <= 0.0) {
+        throw std::invalid_argument("Bad window length: " + spec);
+    }
+    if (agg.empty() || agg == "max") w.agg = Agg::Max;
+    else if (agg == "mean") w.agg = Agg::Mean;
+    else throw std::invalid_argument("Unknown window aggregate (want max|mean): " + spec);
+    return w;
+}
+
+std::string WindowSpec::key() const {
+    std::ostringstream os;
+    os << (kind == Kind::Sliding ? "sliding:" : "tumbling:") << length_s
+       << (agg == Agg::Max ? ":max" : ":mean");
+    return os.str();
+}
+
+// -------------------- WindowedTopK --------------------
+WindowedTopK::WindowedTopK(const WindowSpec& spec, double pane_s, size_t k)
+    : spec_(spec), k_(k) {
+    if (spec.kind == WindowSpec::Kind::Tumbling || pane_s <= 0.0 || pane_s > spec.length_s) {
+        pane_s = spec.length_s;
+    }
+    pane_s_ = pane_s;
+    panes_ = std::max<size_t>(1, static_cast<size_t>(std::ceil(spec.length_s / pane_s - 1e-9)));
+}
+
+int64_t WindowedTopK::paneOf(double t) const {
+    return static_cast<int64_t>(std::floor(t / pane_s_));
+}
+
+size_t WindowedTopK::ringPos(int64_t pane) const {
+    const int64_t n = static_cast<int64_t>(panes_);
+    return static_cast<size_t>(((pane % n) + n) % n);
+}
+
+void WindowedTopK::add(TrackHandle h, double t, double score) {
+    const int64_t p = paneOf(t);
+    if (p > newest_) roll(p);
+    if (p <= newest_ - static_cast<int64_t>(panes_)) return;   // already expired
+
+    auto [it, fresh] = slotOf_.try_emplace(h, 0u);
+    if (fresh) {
+        if (freeSlots_.empty()) {
+            it->second = static_cast<uint32_t>(slots_.size());
+            slots_.emplace_back();
+            ring_.resize(ring_.size() + panes_);
+        } else {
+            it->second = freeSlots_.back();
+            freeSlots_.pop_back();
+        }
+        slots_[it->second] = Slot{};
+        slots_[it->second].track = h;
+    }
+    const uint32_t s = it->second;
+    Slot& slot = slots_[s];
+
+    Pane& pane = ring_[s * panes_ + ringPos(p)];
+    if (pane.index != p) {
+        pane = Pane{};
+        pane.index = p;
+        pane.max = score;
+        paneSlots_[static_cast<size_t>(p - (newest_ - static_cast<int64_t>(panes_) + 1))].second.push_back(s);
+    }
+    pane.max = std::max(pane.max, score);
+    pane.sum += score;
+    ++pane.count;
+
+    slot.max = slot.count == 0 ? score : std::max(slot.max, score);
+    slot.sum += score;
+    ++slot.count;
+}
+
+void WindowedTopK::advance(double now) {
+    const int64_t p = paneOf(now);
+    if (p > newest_) roll(p);
+}
+
+void WindowedTopK::roll(int64_t pane) {
+    if (spec_.kind == WindowSpec::Kind::Tumbling && !slotOf_.empty()) closed_.push_back(topK());
+
+    const int64_t start = pane - static_cast<int64_t>(panes_) + 1;
+    while (!paneSlots_.empty() && paneSlots_.front().first < start) {
+        const int64_t idx = paneSlots_.front().first;
+        for (uint32_t s : paneSlots_.front().second) {
+            Slot& slot = slots_[s];
+            const Pane& p = ring_[s * panes_ + ringPos(idx)];
+            if (p.index != idx) continue;
+            slot.sum -= p.sum;
+            slot.count -= p.count;
+            if (p.max >= slot.max) slot.maxStale = true;
+            if (slot.count == 0) {
+                slotOf_.erase(slot.track);
+                freeSlots_.push_back(s);
+            }
+        }
+        paneSlots_.pop_front();
+    }
+
+    for (int64_t i = std::max(newest_ == INT64_MIN ? start : newest_ + 1, start); i <= pane; ++i) {
+        paneSlots_.emplace_back(i, std::vector<uint32_t>{});
+    }
+    newest_ = pane;
+}
+
+double WindowedTopK::value(uint32_t s) {
+    Slot& slot = slots_[s];
+    if (spec_.agg == WindowSpec::Agg::Mean) return slot.sum / slot.count;
+    if (slot.maxStale) {
+        const int64_t start = newest_ - static_cast<int64_t>(panes_) + 1;
+        bool any = false;
+        for (size_t i = 0; i < panes_; ++i) {
+            const Pane& p = ring_[s * panes_ + i];
+            if (p.index < start || p.count == 0) continue;
+            slot.max = any ? std::max(slot.max, p.max) : p.max;
+            any = true;
+        }
+        slot.maxStale = false;
+    }
+    return slot.max;
+}
+
+WindowResult WindowedTopK::topK() {
+    WindowResult r;
+    r.start = static_cast<double>(newest_ - static_cast<int64_t>(panes_) + 1) * pane_s_;
+    r.end = static_cast<double>(newest_ + 1) * pane_s_;
+    r.top.reserve(slotOf_.size());
+    for (const auto& [h, s] : slotOf_) r.top.push_back({ h, value(s), slots_[s].count });
+
+    auto better = [](const WindowEntry& a, const WindowEntry& b) {
+        return a.value != b.value ? a.value > b.value : a.track < b.track;
+    };
+    if (r.top.size() > k_) {
+        std::nth_element(r.top.begin(), r.top.begin() + k_, r.top.end(), better);
+        r.top.resize(k_);
+    }
+    std::sort(r.top.begin(), r.top.end(), better);
+    return r;
+}
+
+WindowResult WindowedTopK::current() {
+    return topK();
+}
+
+std::vector<WindowResult> WindowedTopK::takeClosed() {
+    std::vector<WindowResult> out;
+    out.swap(closed_);
+    return out;
+}
+
+void WindowedTopK::flush() {
+    if (spec_.kind == WindowSpec::Kind::Tumbling && newest_ != INT64_MIN) roll(newest_ + 1);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "track_store.hpp"
+
+// -------------------- Windowed Top-K --------------------
+// Per-track score aggregates over a window of stream time, keyed by track.
+//   sliding:S[:max|mean]    the last S seconds, re-evaluated every cycle
+//   tumbling:S[:max|mean]   consecutive S-second windows, reported as each
+//                           one closes
+// Time is cut into panes (the serve period for sliding windows, the whole
+// window for tumbling ones). Each active track keeps one (max, sum, count)
+// aggregate per pane of the window plus running window totals; when a pane
+// falls out of the window, only the tracks that had samples in it are
+// adjusted, and a track with nothing left in the window is dropped. Memory
+// and per-cycle work therefore follow the number of active tracks, not the
+// number of samples in the window.
+struct WindowSpec {
+    enum class Kind { Sliding, Tumbling };
+    enum class Agg { Max, Mean };
+
+    Kind kind = Kind::Sliding;
+    Agg agg = Agg::Max;
+    double length_s = 60.0;
+
+    // Throws std::invalid_argument on a bad spec.
+    static WindowSpec parse(const std::string& spec);
+
+    std::string key() const;
+};
+
+struct WindowEntry {
+    TrackHandle track;
+    double value;       // max or mean score in the window
+    uint32_t samples;
+};
+
+struct WindowResult {
+    double start;       // window covers [start, end)
+    double end;
+    std::vector<WindowEntry> top;   // best first
+};
+
+class WindowedTopK {
+public:
+    // pane_s is the sliding-window resolution; ignored for tumbling windows.
+    WindowedTopK(const WindowSpec& spec, double pane_s, size_t k);
+
+    const WindowSpec& spec() const { return spec_; }
+
+    // Record a score sample; samples already outside the window are ignored.
+    void add(TrackHandle h, double t, double score);
+
+    // Move the window's end up to time now.
+    void advance(double now);
+
+    // Sliding: top-K of the current window.
+    WindowResult current();
+
+    // Tumbling: windows closed since the last call, oldest first. flush()
+    // closes the open window too (end of stream); a no-op when sliding.
+    std::vector<WindowResult> takeClosed();
+    void flush();
+
+    size_t activeTracks() const { return slotOf_.size(); }
+
+private:
+    struct Pane {
+        int64_t index = INT64_MIN;
+        double max = 0.0;
+        double sum = 0.0;
+        uint32_t count = 0;
+    };
+    struct Slot {
+        TrackHandle track = 0;
+        double sum = 0.0;
+        uint32_t count = 0;
+        double max = 0.0;
+        bool maxStale = false;
+    };
+
+    int64_t paneOf(double t) const;
+    size_t ringPos(int64_t pane) const;   // pane's place in a slot's ring
+    void roll(int64_t pane);   // make `pane` the newest pane in the window
+    double value(uint32_t slot);
+    WindowResult topK();
+
+    WindowSpec spec_;
+    double pane_s_;
+    size_t panes_;      // panes per window
+    size_t k_;
+
+    int64_t newest_ = INT64_MIN;   // newest pane index in the window
+
+    std::unordered_map<TrackHandle, uint32_t> slotOf_;
+    std::vector<Slot> slots_;
+    std::vector<Pane> ring_;            // panes_ per slot
+    std::vector<uint32_t> freeSlots_;
+    std::deque<std::pair<int64_t, std::vector<uint32_t>>> paneSlots_;   // slots with samples, per live pane
+
+    std::vector<WindowResult> closed_;
+};